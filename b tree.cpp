@@ -1,186 +1,832 @@
-#include <iostream>
-#include <vector>
-
-enum class CompletionStatus
-{
-    NOT_STARTED,
-    JUST_STARTED,
-    HALF_COMPLETED,
-    ALMOST_COMPLETED,
-    FINISHED
-};
-
-struct Task
-{
-    std::string name;
-    std::string description;
-    int deadline;
-    CompletionStatus status;
-};
-
-struct BTreeNode
-{
-    std::vector<Task> tasks;
-    std::vector<BTreeNode *> children;
-    bool leaf;
-    int t; // Minimum degree
-};
-
-BTreeNode *createNode(int t, bool leaf)
-{
-    BTreeNode *newNode = new BTreeNode();
-    newNode->leaf = leaf;
-    newNode->t = t;
-    return newNode;
-}
-
-void splitChild(BTreeNode *parent, int index, BTreeNode *child)
-{
-    BTreeNode *newNode = createNode(child->t, child->leaf);
-    newNode->tasks.resize(child->t - 1);
-
-    for (int i = 0; i < child->t - 1; i++)
-    {
-        newNode->tasks[i] = child->tasks[i + child->t];
-    }
-
-    if (!child->leaf)
-    {
-        newNode->children.resize(child->t);
-        for (int i = 0; i < child->t; i++)
-            newNode->children[i] = child->children[i + child->t];
-    }
-
-    child->tasks.resize(child->t - 1);
-
-    parent->tasks.insert(parent->tasks.begin() + index, child->tasks[child->t - 1]);
-    parent->children.insert(parent->children.begin() + index + 1, newNode);
-}
-
-void insertNonFull(BTreeNode *node, const Task &task)
-{
-    int i = node->tasks.size() - 1;
-
-    if (node->leaf)
-    {
-        node->tasks.push_back(task);
-        while (i >= 0 && node->tasks[i].deadline > task.deadline)
-        {
-            node->tasks[i + 1] = node->tasks[i];
-            i--;
-        }
-        node->tasks[i + 1] = task;
-    }
-    else
-    {
-        while (i >= 0 && node->tasks[i].deadline > task.deadline)
-            i--;
-
-        i++;
-        if (node->children[i]->tasks.size() == 2 * node->t - 1)
-        {
-            splitChild(node, i, node->children[i]);
-            if (node->tasks[i].deadline < task.deadline)
-                i++;
-        }
-        insertNonFull(node->children[i], task);
-    }
-}
-
-void insert(BTreeNode *&root, const Task &task)
-{
-    if (!root)
-    {
-        root = createNode(3, true);
-        root->tasks.push_back(task);
-    }
-    else
-    {
-        if (root->tasks.size() == 2 * root->t - 1)
-        {
-            BTreeNode *newNode = createNode(root->t, false);
-            newNode->children.push_back(root);
-            splitChild(newNode, 0, root);
-            int i = 0;
-            if (newNode->tasks[0].deadline < task.deadline)
-                i++;
-            insertNonFull(newNode->children[i], task);
-            root = newNode;
-        }
-        else
-            insertNonFull(root, task);
-    }
-}
-
-void traverse(BTreeNode *root)
-{
-    int i;
-    for (i = 0; i < root->tasks.size(); i++)
-    {
-        if (!root->leaf)
-            traverse(root->children[i]);
-        std::cout << "Task: " << root->tasks[i].name << ", Deadline: " << root->tasks[i].deadline << ", Status: ";
-        switch (root->tasks[i].status)
-        {
-        case CompletionStatus::NOT_STARTED:
-            std::cout << "Not Started";
-            break;
-        case CompletionStatus::JUST_STARTED:
-            std::cout << "Just Started";
-            break;
-        case CompletionStatus::HALF_COMPLETED:
-            std::cout << "Half Completed";
-            break;
-        case CompletionStatus::ALMOST_COMPLETED:
-            std::cout << "Almost Completed";
-            break;
-        case CompletionStatus::FINISHED:
-            std::cout << "Finished";
-            break;
-        }
-        std::cout << std::endl;
-    }
-    if (!root->leaf)
-        traverse(root->children[i]);
-}
-
-Task *search(BTreeNode *root, int deadline)
-{
-    int i = 0;
-    while (i < root->tasks.size() && deadline > root->tasks[i].deadline)
-        i++;
-    if (root->tasks[i].deadline == deadline)
-        return &(root->tasks[i]);
-    if (root->leaf)
-        return nullptr;
-    return search(root->children[i], deadline);
-}
-
-int main()
-{
-    BTreeNode *root = nullptr;
-    Task tasks[] = {
-        {"Task1", "Description1", 10, CompletionStatus::NOT_STARTED},
-        {"Task2", "Description2", 20, CompletionStatus::JUST_STARTED},
-        {"Task3", "Description3", 5, CompletionStatus::HALF_COMPLETED},
-        {"Task4", "Description4", 6, CompletionStatus::ALMOST_COMPLETED},
-        {"Task5", "Description5", 12, CompletionStatus::FINISHED},
-        {"Task6", "Description6", 30, CompletionStatus::NOT_STARTED},
-        {"Task7", "Description7", 7, CompletionStatus::HALF_COMPLETED},
-        {"Task8", "Description8", 17, CompletionStatus::ALMOST_COMPLETED}};
-
-    for (const Task &task : tasks)
-        insert(root, task);
-
-    std::cout << "Traversal of the constructed B-tree is:\n";
-    traverse(root);
-
-    int searchDeadline = 6;
-    Task *foundTask = search(root, searchDeadline);
-    if (foundTask)
-        std::cout << "Task with deadline " << searchDeadline << " found: " << foundTask->name << std::endl;
-    else
-        std::cout << "Task with deadline " << searchDeadline << " not found!" << std::endl;
-
-    return 0;
-}
+#include <iostream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+#include <utility>
+
+enum class CompletionStatus
+{
+    NOT_STARTED,
+    JUST_STARTED,
+    HALF_COMPLETED,
+    ALMOST_COMPLETED,
+    FINISHED
+};
+
+struct Task
+{
+    std::string name;
+    std::string description;
+    int deadline;
+    CompletionStatus status;
+};
+
+// Payload handle: index of a Task in the task store. The tree only holds
+// keys and handles, so the strings never travel through the nodes.
+using TaskHandle = std::uint32_t;
+
+constexpr std::size_t kCacheLine = 64;
+
+// Default fanout: as many children as fit an inner node of four cache lines
+template <typename Key>
+constexpr int defaultFanout()
+{
+    return static_cast<int>((4 * kCacheLine - 16) / (sizeof(Key) + sizeof(void *)));
+}
+
+constexpr std::size_t kParallelSortThreshold = 1 << 16;
+
+// Stable sort split across the hardware threads: each thread sorts one run,
+// then neighbouring runs are merged pairwise in parallel
+template <typename T, typename Less>
+void parallelStableSort(std::vector<T> &items, Less less)
+{
+    std::size_t threads = std::thread::hardware_concurrency();
+    if (threads < 2 || items.size() < kParallelSortThreshold)
+    {
+        std::stable_sort(items.begin(), items.end(), less);
+        return;
+    }
+
+    std::vector<std::size_t> bounds(threads + 1);
+    for (std::size_t i = 0; i <= threads; ++i)
+        bounds[i] = items.size() * i / threads;
+
+    std::vector<std::thread> workers;
+    for (std::size_t i = 0; i < threads; ++i)
+        workers.emplace_back([&, i]
+                             { std::stable_sort(items.begin() + bounds[i], items.begin() + bounds[i + 1], less); });
+    for (std::thread &worker : workers)
+        worker.join();
+
+    for (std::size_t width = 1; width < threads; width *= 2)
+    {
+        workers.clear();
+        for (std::size_t i = 0; i + width < threads; i += 2 * width)
+        {
+            std::size_t mid = bounds[i + width];
+            std::size_t hi = bounds[std::min(i + 2 * width, threads)];
+            workers.emplace_back([&, i, mid, hi]
+                                 { std::inplace_merge(items.begin() + bounds[i], items.begin() + mid, items.begin() + hi, less); });
+        }
+        for (std::thread &worker : workers)
+            worker.join();
+    }
+}
+
+// B+ tree mapping Key to Value with duplicate keys allowed. Inner nodes hold
+// only separator keys and child pointers; leaves hold keys and values in
+// separate arrays and are linked in key order for range scans. Entries with
+// equal keys keep insertion order.
+template <typename Key, typename Value, int Fanout = defaultFanout<Key>()>
+class BPlusTree
+{
+    static_assert(Fanout >= 4, "B+ tree fanout must be at least 4");
+
+    static constexpr int kLeafMin = Fanout / 2;
+    static constexpr int kInnerMaxKeys = Fanout - 1;
+    static constexpr int kInnerMinKeys = (Fanout - 2) / 2;
+
+    struct Node
+    {
+        explicit Node(bool isLeaf) : leaf(isLeaf), count(0) {}
+        bool leaf;
+        int count; // Number of keys in the node
+    };
+
+    // Keys in a leaf lie within the separators around it in its parent:
+    // children[i] only holds keys k with keys[i - 1] <= k <= keys[i]
+    struct alignas(kCacheLine) Leaf : Node
+    {
+        Leaf() : Node(true) {}
+        Leaf *prev = nullptr;
+        Leaf *next = nullptr;
+        Key keys[Fanout];
+        Value values[Fanout];
+    };
+
+    struct alignas(kCacheLine) Inner : Node
+    {
+        Inner() : Node(false) {}
+        Key keys[kInnerMaxKeys];
+        Node *children[Fanout];
+    };
+
+    static Leaf *asLeaf(Node *node)
+    {
+        return static_cast<Leaf *>(node);
+    }
+
+    static Inner *asInner(Node *node)
+    {
+        return static_cast<Inner *>(node);
+    }
+
+public:
+    using Entry = std::pair<Key, Value>;
+
+    // Forward iterator over the leaf chain; dereferences to the value
+    class const_iterator
+    {
+    public:
+        const_iterator() = default;
+
+        const Key &key() const
+        {
+            return leaf->keys[pos];
+        }
+
+        const Value &value() const
+        {
+            return leaf->values[pos];
+        }
+
+        const Value &operator*() const
+        {
+            return leaf->values[pos];
+        }
+
+        const_iterator &operator++()
+        {
+            if (++pos == leaf->count)
+            {
+                leaf = leaf->next;
+                pos = 0;
+            }
+            return *this;
+        }
+
+        bool operator==(const const_iterator &other) const
+        {
+            return leaf == other.leaf && pos == other.pos;
+        }
+
+        bool operator!=(const const_iterator &other) const
+        {
+            return !(*this == other);
+        }
+
+    private:
+        friend class BPlusTree;
+        const_iterator(const Leaf *at, int index) : leaf(at), pos(index)
+        {
+            if (leaf && pos == leaf->count)
+            {
+                leaf = leaf->next;
+                pos = 0;
+            }
+        }
+
+        const Leaf *leaf = nullptr;
+        int pos = 0;
+    };
+
+    // Half-open iterator pair usable in a range-based for loop
+    struct Range
+    {
+        const_iterator first;
+        const_iterator last;
+        const_iterator begin() const { return first; }
+        const_iterator end() const { return last; }
+    };
+
+    BPlusTree() = default;
+    BPlusTree(const BPlusTree &) = delete;
+    BPlusTree &operator=(const BPlusTree &) = delete;
+
+    ~BPlusTree()
+    {
+        clear();
+    }
+
+    void clear()
+    {
+        destroy(root);
+        root = nullptr;
+        entries = 0;
+        treeHeight = 0;
+    }
+
+    std::size_t size() const
+    {
+        return entries;
+    }
+
+    bool empty() const
+    {
+        return entries == 0;
+    }
+
+    int height() const
+    {
+        return treeHeight;
+    }
+
+    const_iterator begin() const
+    {
+        Node *node = root;
+        while (node && !node->leaf)
+            node = asInner(node)->children[0];
+        return const_iterator(node ? asLeaf(node) : nullptr, 0);
+    }
+
+    const_iterator end() const
+    {
+        return const_iterator();
+    }
+
+    // First entry with a key not less than key
+    const_iterator lowerBound(const Key &key) const
+    {
+        if (!root)
+            return end();
+        Node *node = root;
+        while (!node->leaf)
+        {
+            Inner *inner = asInner(node);
+            node = inner->children[std::lower_bound(inner->keys, inner->keys + inner->count, key) - inner->keys];
+        }
+        Leaf *leaf = asLeaf(node);
+        return const_iterator(leaf, static_cast<int>(std::lower_bound(leaf->keys, leaf->keys + leaf->count, key) - leaf->keys));
+    }
+
+    // First entry with a key greater than key
+    const_iterator upperBound(const Key &key) const
+    {
+        if (!root)
+            return end();
+        Node *node = root;
+        while (!node->leaf)
+        {
+            Inner *inner = asInner(node);
+            node = inner->children[std::upper_bound(inner->keys, inner->keys + inner->count, key) - inner->keys];
+        }
+        Leaf *leaf = asLeaf(node);
+        return const_iterator(leaf, static_cast<int>(std::upper_bound(leaf->keys, leaf->keys + leaf->count, key) - leaf->keys));
+    }
+
+    // First entry with exactly this key, or end()
+    const_iterator find(const Key &key) const
+    {
+        const_iterator it = lowerBound(key);
+        if (it != end() && !(key < it.key()))
+            return it;
+        return end();
+    }
+
+    // Every entry with exactly this key, in insertion order
+    Range equalRange(const Key &key) const
+    {
+        return Range{lowerBound(key), upperBound(key)};
+    }
+
+    std::size_t count(const Key &key) const
+    {
+        std::size_t n = 0;
+        for (const_iterator it = lowerBound(key), last = upperBound(key); it != last; ++it)
+            ++n;
+        return n;
+    }
+
+    // Every entry with first <= key <= last, in key order
+    Range range(const Key &first, const Key &last) const
+    {
+        if (last < first)
+            return Range{end(), end()};
+        return Range{lowerBound(first), upperBound(last)};
+    }
+
+    // Insert after any entries with an equal key. Full nodes on the path are
+    // split on the way down so the insert never has to walk back up.
+    void insert(const Key &key, const Value &value)
+    {
+        if (!root)
+        {
+            root = new Leaf();
+            treeHeight = 1;
+        }
+        if (isFull(root))
+        {
+            Inner *newRoot = new Inner();
+            newRoot->children[0] = root;
+            splitChild(newRoot, 0);
+            root = newRoot;
+            ++treeHeight;
+        }
+        insertNonFull(root, key, value);
+        ++entries;
+    }
+
+    // Replace the contents with items. The items are sorted (in parallel for
+    // large inputs) and the tree is built bottom-up one level at a time, so
+    // the cost is the sort plus a linear pass with no splits.
+    void bulkLoad(std::vector<Entry> items)
+    {
+        parallelStableSort(items, entryLess);
+        buildFromSorted(items);
+    }
+
+    // Insert a batch of entries. A batch at least as large as the tree is
+    // merged with the existing entries and rebuilt bottom-up; a smaller one
+    // is sorted and merged leaf by leaf, one descent and one shift per leaf
+    // instead of per entry.
+    void insertBatch(std::vector<Entry> batch)
+    {
+        if (batch.empty())
+            return;
+        parallelStableSort(batch, entryLess);
+
+        if (batch.size() >= entries)
+        {
+            std::vector<Entry> merged;
+            merged.reserve(entries + batch.size());
+            const_iterator it = begin();
+            for (const Entry &item : batch)
+            {
+                for (; it != end() && !(item.first < it.key()); ++it)
+                    merged.emplace_back(it.key(), it.value());
+                merged.push_back(item);
+            }
+            for (; it != end(); ++it)
+                merged.emplace_back(it.key(), it.value());
+            buildFromSorted(merged);
+            return;
+        }
+
+        std::size_t pos = 0;
+        while (pos < batch.size())
+        {
+            // Find the leaf for batch[pos] and the first key past its range
+            Node *node = root;
+            const Key *limit = nullptr;
+            while (!node->leaf)
+            {
+                Inner *inner = asInner(node);
+                int i = static_cast<int>(std::upper_bound(inner->keys, inner->keys + inner->count, batch[pos].first) - inner->keys);
+                if (i < inner->count)
+                    limit = &inner->keys[i];
+                node = inner->children[i];
+            }
+
+            Leaf *leaf = asLeaf(node);
+            if (leaf->count == Fanout)
+            {
+                // Let a regular insert split the leaf, then carry on merging
+                insert(batch[pos].first, batch[pos].second);
+                ++pos;
+                continue;
+            }
+
+            std::size_t run = pos + 1;
+            std::size_t cap = pos + (Fanout - leaf->count);
+            while (run < batch.size() && run < cap && (!limit || batch[run].first < *limit))
+                ++run;
+            mergeIntoLeaf(leaf, batch.data() + pos, static_cast<int>(run - pos));
+            entries += run - pos;
+            pos = run;
+        }
+    }
+
+    // Remove the entry with this key and value. Returns false if absent.
+    bool erase(const Key &key, const Value &value)
+    {
+        if (!root || !eraseFrom(root, key, value))
+            return false;
+        --entries;
+
+        // Shrink the tree when the root runs out of keys
+        if (root->leaf && root->count == 0)
+        {
+            delete asLeaf(root);
+            root = nullptr;
+            treeHeight = 0;
+        }
+        else if (!root->leaf && root->count == 0)
+        {
+            Inner *old = asInner(root);
+            root = old->children[0];
+            delete old;
+            --treeHeight;
+        }
+        return true;
+    }
+
+private:
+    static bool entryLess(const Entry &a, const Entry &b)
+    {
+        return a.first < b.first;
+    }
+
+    // Merge n sorted entries into a leaf with room for them, working from
+    // the back; new entries go after existing ones with an equal key
+    static void mergeIntoLeaf(Leaf *leaf, const Entry *items, int n)
+    {
+        int i = leaf->count - 1;
+        int j = n - 1;
+        for (int w = leaf->count + n - 1; j >= 0; --w)
+        {
+            if (i >= 0 && items[j].first < leaf->keys[i])
+            {
+                leaf->keys[w] = leaf->keys[i];
+                leaf->values[w] = leaf->values[i];
+                --i;
+            }
+            else
+            {
+                leaf->keys[w] = items[j].first;
+                leaf->values[w] = items[j].second;
+                --j;
+            }
+        }
+        leaf->count += n;
+    }
+
+    // Build the tree from entries already in key order. Each level is split
+    // into the fewest nodes that can hold it, with entries spread evenly so
+    // every node stays at or above the minimum fill.
+    void buildFromSorted(const std::vector<Entry> &items)
+    {
+        clear();
+        if (items.empty())
+            return;
+
+        std::vector<Node *> level;
+        std::vector<Key> lowKeys;
+        std::size_t leafCount = (items.size() + Fanout - 1) / Fanout;
+        Leaf *prev = nullptr;
+        for (std::size_t l = 0; l < leafCount; ++l)
+        {
+            std::size_t first = items.size() * l / leafCount;
+            std::size_t last = items.size() * (l + 1) / leafCount;
+            Leaf *leaf = new Leaf();
+            for (std::size_t k = first; k < last; ++k)
+            {
+                leaf->keys[k - first] = items[k].first;
+                leaf->values[k - first] = items[k].second;
+            }
+            leaf->count = static_cast<int>(last - first);
+            leaf->prev = prev;
+            if (prev)
+                prev->next = leaf;
+            prev = leaf;
+            level.push_back(leaf);
+            lowKeys.push_back(leaf->keys[0]);
+        }
+        treeHeight = 1;
+
+        while (level.size() > 1)
+        {
+            std::vector<Node *> parents;
+            std::vector<Key> parentLows;
+            std::size_t groups = (level.size() + Fanout - 1) / Fanout;
+            for (std::size_t g = 0; g < groups; ++g)
+            {
+                std::size_t first = level.size() * g / groups;
+                std::size_t last = level.size() * (g + 1) / groups;
+                Inner *inner = new Inner();
+                inner->children[0] = level[first];
+                for (std::size_t c = first + 1; c < last; ++c)
+                {
+                    inner->keys[c - first - 1] = lowKeys[c];
+                    inner->children[c - first] = level[c];
+                }
+                inner->count = static_cast<int>(last - first - 1);
+                parents.push_back(inner);
+                parentLows.push_back(lowKeys[first]);
+            }
+            level.swap(parents);
+            lowKeys.swap(parentLows);
+            ++treeHeight;
+        }
+        root = level[0];
+        entries = items.size();
+    }
+
+    static bool isFull(const Node *node)
+    {
+        return node->count == (node->leaf ? Fanout : kInnerMaxKeys);
+    }
+
+    static void destroy(Node *node)
+    {
+        if (!node)
+            return;
+        if (node->leaf)
+        {
+            delete asLeaf(node);
+            return;
+        }
+        Inner *inner = asInner(node);
+        for (int i = 0; i <= inner->count; ++i)
+            destroy(inner->children[i]);
+        delete inner;
+    }
+
+    // Add separator key with child right at position index of parent
+    static void insertSeparator(Inner *parent, int index, const Key &key, Node *right)
+    {
+        std::copy_backward(parent->keys + index, parent->keys + parent->count, parent->keys + parent->count + 1);
+        std::copy_backward(parent->children + index + 1, parent->children + parent->count + 1, parent->children + parent->count + 2);
+        parent->keys[index] = key;
+        parent->children[index + 1] = right;
+        ++parent->count;
+    }
+
+    // Remove separator index and the child to its right from parent
+    static void removeSeparator(Inner *parent, int index)
+    {
+        std::copy(parent->keys + index + 1, parent->keys + parent->count, parent->keys + index);
+        std::copy(parent->children + index + 2, parent->children + parent->count + 1, parent->children + index + 1);
+        --parent->count;
+    }
+
+    // Split the full child at index of a non-full parent in two halves
+    static void splitChild(Inner *parent, int index)
+    {
+        Node *child = parent->children[index];
+        if (child->leaf)
+        {
+            Leaf *left = asLeaf(child);
+            Leaf *right = new Leaf();
+            int mid = left->count / 2;
+            right->count = left->count - mid;
+            std::copy(left->keys + mid, left->keys + left->count, right->keys);
+            std::copy(left->values + mid, left->values + left->count, right->values);
+            left->count = mid;
+
+            right->next = left->next;
+            right->prev = left;
+            if (left->next)
+                left->next->prev = right;
+            left->next = right;
+            insertSeparator(parent, index, right->keys[0], right);
+            return;
+        }
+
+        // The middle key moves up and is not kept in either half
+        Inner *left = asInner(child);
+        Inner *right = new Inner();
+        int mid = left->count / 2;
+        right->count = left->count - mid - 1;
+        std::copy(left->keys + mid + 1, left->keys + left->count, right->keys);
+        std::copy(left->children + mid + 1, left->children + left->count + 1, right->children);
+        left->count = mid;
+        insertSeparator(parent, index, left->keys[mid], right);
+    }
+
+    static void insertNonFull(Node *node, const Key &key, const Value &value)
+    {
+        while (!node->leaf)
+        {
+            Inner *inner = asInner(node);
+            int i = static_cast<int>(std::upper_bound(inner->keys, inner->keys + inner->count, key) - inner->keys);
+            if (isFull(inner->children[i]))
+            {
+                splitChild(inner, i);
+                if (!(key < inner->keys[i]))
+                    i++;
+            }
+            node = inner->children[i];
+        }
+
+        Leaf *leaf = asLeaf(node);
+        int pos = static_cast<int>(std::upper_bound(leaf->keys, leaf->keys + leaf->count, key) - leaf->keys);
+        std::copy_backward(leaf->keys + pos, leaf->keys + leaf->count, leaf->keys + leaf->count + 1);
+        std::copy_backward(leaf->values + pos, leaf->values + leaf->count, leaf->values + leaf->count + 1);
+        leaf->keys[pos] = key;
+        leaf->values[pos] = value;
+        ++leaf->count;
+    }
+
+    // Equal keys may straddle several children, so every child that can
+    // hold key is tried; the one that held the entry is rebalanced
+    bool eraseFrom(Node *node, const Key &key, const Value &value)
+    {
+        if (node->leaf)
+        {
+            Leaf *leaf = asLeaf(node);
+            int pos = static_cast<int>(std::lower_bound(leaf->keys, leaf->keys + leaf->count, key) - leaf->keys);
+            for (; pos < leaf->count && !(key < leaf->keys[pos]); ++pos)
+            {
+                if (leaf->values[pos] == value)
+                {
+                    std::copy(leaf->keys + pos + 1, leaf->keys + leaf->count, leaf->keys + pos);
+                    std::copy(leaf->values + pos + 1, leaf->values + leaf->count, leaf->values + pos);
+                    --leaf->count;
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        Inner *inner = asInner(node);
+        int first = static_cast<int>(std::lower_bound(inner->keys, inner->keys + inner->count, key) - inner->keys);
+        int last = static_cast<int>(std::upper_bound(inner->keys, inner->keys + inner->count, key) - inner->keys);
+        for (int i = first; i <= last; ++i)
+        {
+            if (eraseFrom(inner->children[i], key, value))
+            {
+                Node *child = inner->children[i];
+                if (child->count < (child->leaf ? kLeafMin : kInnerMinKeys))
+                    rebalance(inner, i);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Refill the underfull child at index by borrowing from a sibling, or
+    // merge it with one when both are at the minimum
+    void rebalance(Inner *parent, int index)
+    {
+        Node *child = parent->children[index];
+        Node *left = index > 0 ? parent->children[index - 1] : nullptr;
+        Node *right = index < parent->count ? parent->children[index + 1] : nullptr;
+
+        if (child->leaf)
+        {
+            Leaf *leaf = asLeaf(child);
+            if (left && left->count > kLeafMin)
+            {
+                Leaf *from = asLeaf(left);
+                std::copy_backward(leaf->keys, leaf->keys + leaf->count, leaf->keys + leaf->count + 1);
+                std::copy_backward(leaf->values, leaf->values + leaf->count, leaf->values + leaf->count + 1);
+                --from->count;
+                leaf->keys[0] = from->keys[from->count];
+                leaf->values[0] = from->values[from->count];
+                ++leaf->count;
+                parent->keys[index - 1] = leaf->keys[0];
+            }
+            else if (right && right->count > kLeafMin)
+            {
+                Leaf *from = asLeaf(right);
+                leaf->keys[leaf->count] = from->keys[0];
+                leaf->values[leaf->count] = from->values[0];
+                ++leaf->count;
+                std::copy(from->keys + 1, from->keys + from->count, from->keys);
+                std::copy(from->values + 1, from->values + from->count, from->values);
+                --from->count;
+                parent->keys[index] = from->keys[0];
+            }
+            else if (left)
+                mergeLeaves(parent, index - 1);
+            else
+                mergeLeaves(parent, index);
+            return;
+        }
+
+        Inner *inner = asInner(child);
+        if (left && left->count > kInnerMinKeys)
+        {
+            // Rotate right through the parent separator
+            Inner *from = asInner(left);
+            std::copy_backward(inner->keys, inner->keys + inner->count, inner->keys + inner->count + 1);
+            std::copy_backward(inner->children, inner->children + inner->count + 1, inner->children + inner->count + 2);
+            inner->keys[0] = parent->keys[index - 1];
+            inner->children[0] = from->children[from->count];
+            ++inner->count;
+            parent->keys[index - 1] = from->keys[from->count - 1];
+            --from->count;
+        }
+        else if (right && right->count > kInnerMinKeys)
+        {
+            // Rotate left through the parent separator
+            Inner *from = asInner(right);
+            inner->keys[inner->count] = parent->keys[index];
+            inner->children[inner->count + 1] = from->children[0];
+            ++inner->count;
+            parent->keys[index] = from->keys[0];
+            std::copy(from->keys + 1, from->keys + from->count, from->keys);
+            std::copy(from->children + 1, from->children + from->count + 1, from->children);
+            --from->count;
+        }
+        else if (left)
+            mergeInner(parent, index - 1);
+        else
+            mergeInner(parent, index);
+    }
+
+    // Fold the leaf right of separator index into the one on its left
+    static void mergeLeaves(Inner *parent, int index)
+    {
+        Leaf *left = asLeaf(parent->children[index]);
+        Leaf *right = asLeaf(parent->children[index + 1]);
+        std::copy(right->keys, right->keys + right->count, left->keys + left->count);
+        std::copy(right->values, right->values + right->count, left->values + left->count);
+        left->count += right->count;
+        left->next = right->next;
+        if (right->next)
+            right->next->prev = left;
+        removeSeparator(parent, index);
+        delete right;
+    }
+
+    // Pull separator index down and fold the right inner node into the left
+    static void mergeInner(Inner *parent, int index)
+    {
+        Inner *left = asInner(parent->children[index]);
+        Inner *right = asInner(parent->children[index + 1]);
+        left->keys[left->count] = parent->keys[index];
+        std::copy(right->keys, right->keys + right->count, left->keys + left->count + 1);
+        std::copy(right->children, right->children + right->count + 1, left->children + left->count + 1);
+        left->count += right->count + 1;
+        removeSeparator(parent, index);
+        delete right;
+    }
+
+    Node *root = nullptr;
+    std::size_t entries = 0;
+    int treeHeight = 0;
+};
+
+// Deadline index over a task store: deadlines are the keys, positions in
+// the store the payload
+using DeadlineIndex = BPlusTree<int, TaskHandle>;
+
+const char *statusName(CompletionStatus status)
+{
+    switch (status)
+    {
+    case CompletionStatus::NOT_STARTED:
+        return "Not Started";
+    case CompletionStatus::JUST_STARTED:
+        return "Just Started";
+    case CompletionStatus::HALF_COMPLETED:
+        return "Half Completed";
+    case CompletionStatus::ALMOST_COMPLETED:
+        return "Almost Completed";
+    case CompletionStatus::FINISHED:
+        return "Finished";
+    }
+    return "";
+}
+
+void printTask(const Task &task)
+{
+    std::cout << "Task: " << task.name << ", Deadline: " << task.deadline << ", Status: " << statusName(task.status)
+              << std::endl;
+}
+
+void traverse(const DeadlineIndex &index, const std::vector<Task> &store)
+{
+    for (TaskHandle handle : index)
+        printTask(store[handle]);
+}
+
+// Define DEADLINE_INDEX_NO_MAIN to include this file from another program
+#ifndef DEADLINE_INDEX_NO_MAIN
+int main()
+{
+    std::vector<Task> store = {
+        {"Task1", "Description1", 10, CompletionStatus::NOT_STARTED},
+        {"Task2", "Description2", 20, CompletionStatus::JUST_STARTED},
+        {"Task3", "Description3", 5, CompletionStatus::HALF_COMPLETED},
+        {"Task4", "Description4", 6, CompletionStatus::ALMOST_COMPLETED},
+        {"Task5", "Description5", 12, CompletionStatus::FINISHED},
+        {"Task6", "Description6", 30, CompletionStatus::NOT_STARTED},
+        {"Task7", "Description7", 7, CompletionStatus::HALF_COMPLETED},
+        {"Task8", "Description8", 17, CompletionStatus::ALMOST_COMPLETED}};
+
+    DeadlineIndex index;
+    std::vector<DeadlineIndex::Entry> entries;
+    for (std::size_t i = 0; i < store.size(); ++i)
+        entries.emplace_back(store[i].deadline, static_cast<TaskHandle>(i));
+    index.bulkLoad(std::move(entries));
+
+    std::cout << "Traversal of the constructed B+ tree is:\n";
+    traverse(index, store);
+
+    int searchDeadline = 6;
+    DeadlineIndex::const_iterator found = index.find(searchDeadline);
+    if (found != index.end())
+        std::cout << "Task with deadline " << searchDeadline << " found: " << store[*found].name << std::endl;
+    else
+        std::cout << "Task with deadline " << searchDeadline << " not found!" << std::endl;
+
+    // Tasks added later share deadlines with existing ones
+    std::vector<DeadlineIndex::Entry> batch;
+    store.push_back({"Task9", "Description9", 6, CompletionStatus::NOT_STARTED});
+    batch.emplace_back(6, static_cast<TaskHandle>(store.size() - 1));
+    store.push_back({"Task10", "Description10", 12, CompletionStatus::JUST_STARTED});
+    batch.emplace_back(12, static_cast<TaskHandle>(store.size() - 1));
+    index.insertBatch(std::move(batch));
+
+    std::cout << index.count(searchDeadline) << " task(s) due at " << searchDeadline << ":\n";
+    for (TaskHandle handle : index.equalRange(searchDeadline))
+        printTask(store[handle]);
+
+    int from = 6, to = 17;
+    std::cout << "Tasks due in [" << from << ", " << to << "]:\n";
+    for (TaskHandle handle : index.range(from, to))
+        printTask(store[handle]);
+
+    index.erase(store[4].deadline, 4);
+    std::cout << "After deleting " << store[4].name << ":\n";
+    traverse(index, store);
+
+    return 0;
+}
+#endif
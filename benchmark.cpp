@@ -0,0 +1,650 @@
+// Benchmarks for the task manager (dsaIdeathon.cpp) and the deadline
+// B+ tree (b tree.cpp) on synthetic workloads.
+//
+// Build: g++ -std=c++17 -O2 -pthread -o benchmark benchmark.cpp
+// Run:   ./benchmark [--sizes 1e3,1e4,1e5] [--graph chain|fanout|layered|all]
+//                    [--layers N] [--degree N] [--reps N] [--seed N] [--json PATH|-]
+//
+// Per-operation benchmarks time every call on its own and report p50/p99
+// latency; whole-pass benchmarks (topological sort, dispatch, display) are
+// repeated --reps times and report p50/p99 per pass. concurrentCall times
+// call() round trips through the concurrent front end under several
+// producers, and exits non-zero if one never completes. loadSnapshot
+// also checks that a WSJF snapshot reloads with the same priorities and
+// dispatch order. ops/s counts tasks handled per second. With --json the
+// results are also written as a JSON array (to stdout for '-') for
+// regression tracking. A malformed option prints the usage and exits 2.
+#include <iostream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <chrono>
+#include <cmath>
+#include <future>
+#include <limits>
+#include <memory>
+#include <random>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+#define TASK_MANAGER_NO_MAIN
+#include "dsaIdeathon.cpp"
+
+// b tree.cpp has its own Task and CompletionStatus, so it gets a namespace.
+// Every standard header it uses is already included above.
+#define DEADLINE_INDEX_NO_MAIN
+namespace btree
+{
+#include "b tree.cpp"
+}
+
+// Discards everything written to it; the task manager reports to std::cout
+class NullBuffer : public std::streambuf
+{
+protected:
+    int overflow(int c) override
+    {
+        return c;
+    }
+
+    std::streamsize xsputn(const char *, std::streamsize count) override
+    {
+        return count;
+    }
+};
+
+struct BenchOptions
+{
+    std::vector<std::size_t> sizes = {1000, 10000, 100000};
+    std::vector<std::string> graphs = {"chain", "fanout", "layered"};
+    std::size_t layers = 32;
+    std::size_t degree = 3;
+    std::size_t reps = 5;
+    unsigned seed = 42;
+    std::string jsonPath;
+};
+
+struct BenchResult
+{
+    std::string name;
+    std::string graph;
+    std::size_t size = 0;
+    std::size_t samples = 0;
+    double p50Ns = 0.0;
+    double p99Ns = 0.0;
+    double opsPerSec = 0.0;
+};
+
+// Dependency edges (task, dependency) over tasks 0..n-1. Every edge points
+// at a lower index, so each graph is acyclic.
+using EdgeList = std::vector<std::pair<std::uint32_t, std::uint32_t>>;
+
+// Task i depends on task i - 1
+EdgeList chainGraph(std::size_t n)
+{
+    EdgeList edges;
+    edges.reserve(n);
+    for (std::size_t i = 1; i < n; ++i)
+        edges.emplace_back(static_cast<std::uint32_t>(i), static_cast<std::uint32_t>(i - 1));
+    return edges;
+}
+
+// Every task depends on task 0
+EdgeList fanoutGraph(std::size_t n)
+{
+    EdgeList edges;
+    edges.reserve(n);
+    for (std::size_t i = 1; i < n; ++i)
+        edges.emplace_back(static_cast<std::uint32_t>(i), 0);
+    return edges;
+}
+
+// Tasks split into equal layers; each task outside the first layer depends
+// on `degree` random tasks of the layer before it
+EdgeList layeredGraph(std::size_t n, std::size_t layers, std::size_t degree, std::mt19937 &rng)
+{
+    EdgeList edges;
+    layers = std::max<std::size_t>(1, std::min(layers, n));
+    edges.reserve(n * degree);
+    for (std::size_t l = 1; l < layers; ++l)
+    {
+        std::size_t prevFirst = n * (l - 1) / layers;
+        std::size_t first = n * l / layers;
+        std::size_t last = n * (l + 1) / layers;
+        std::uniform_int_distribution<std::size_t> pick(prevFirst, first - 1);
+        for (std::size_t i = first; i < last; ++i)
+        {
+            for (std::size_t d = 0; d < degree; ++d)
+                edges.emplace_back(static_cast<std::uint32_t>(i), static_cast<std::uint32_t>(pick(rng)));
+        }
+    }
+    return edges;
+}
+
+double nowNs()
+{
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// p50/p99 of the samples (ns); ops/s from the total time and task count
+BenchResult summarize(const std::string &name, const std::string &graph, std::size_t size, std::vector<double> &samples, std::size_t opsPerSample)
+{
+    BenchResult result;
+    result.name = name;
+    result.graph = graph;
+    result.size = size;
+    result.samples = samples.size();
+    if (samples.empty())
+        return result;
+
+    double total = 0.0;
+    for (double ns : samples)
+        total += ns;
+    auto at = [&](double q)
+    {
+        std::size_t k = std::min(samples.size() - 1, static_cast<std::size_t>(q * samples.size()));
+        std::nth_element(samples.begin(), samples.begin() + k, samples.end());
+        return samples[k];
+    };
+    result.p50Ns = at(0.50);
+    result.p99Ns = at(0.99);
+    if (total > 0.0)
+        result.opsPerSec = samples.size() * opsPerSample / (total * 1e-9);
+    return result;
+}
+
+std::vector<std::string> taskNames(std::size_t n)
+{
+    std::vector<std::string> names;
+    names.reserve(n);
+    for (std::size_t i = 0; i < n; ++i)
+        names.push_back("t" + std::to_string(i));
+    return names;
+}
+
+// A manager holding the whole graph, built through the bulk paths
+void buildManager(TaskManager &manager, const std::vector<std::string> &names, const EdgeList &edges, std::mt19937 &rng)
+{
+    std::uniform_int_distribution<int> deadline(0, 100);
+    std::vector<TaskRecord> records(names.size());
+    for (std::size_t i = 0; i < names.size(); ++i)
+    {
+        records[i].name = names[i];
+        records[i].description = "benchmark task";
+        records[i].deadline = deadline(rng);
+    }
+    manager.addTasksBulk(records);
+
+    std::vector<std::pair<std::string, std::string>> namedEdges;
+    namedEdges.reserve(edges.size());
+    for (const auto &edge : edges)
+        namedEdges.emplace_back(names[edge.first], names[edge.second]);
+    manager.addDependenciesBulk(namedEdges);
+}
+
+void benchTaskManager(const BenchOptions &options, const std::string &graph, std::size_t n, std::vector<BenchResult> &results)
+{
+    std::mt19937 rng(options.seed);
+    EdgeList edges = graph == "chain" ? chainGraph(n) : graph == "fanout" ? fanoutGraph(n) : layeredGraph(n, options.layers, options.degree, rng);
+    std::vector<std::string> names = taskNames(n);
+    std::vector<double> samples;
+
+    // addTask and addDependency, one timed call each
+    {
+        TaskManager manager;
+        std::uniform_int_distribution<int> deadline(0, 100);
+        samples.clear();
+        samples.reserve(n);
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            int due = deadline(rng);
+            double start = nowNs();
+            manager.addTask(names[i], "benchmark task", due, 0.0);
+            samples.push_back(nowNs() - start);
+        }
+        results.push_back(summarize("addTask", graph, n, samples, 1));
+
+        samples.clear();
+        samples.reserve(edges.size());
+        for (const auto &edge : edges)
+        {
+            double start = nowNs();
+            manager.addDependency(names[edge.first], names[edge.second]);
+            samples.push_back(nowNs() - start);
+        }
+        results.push_back(summarize("addDependency", graph, n, samples, 1));
+
+        // Whole passes over the finished graph
+        samples.clear();
+        for (std::size_t r = 0; r < options.reps; ++r)
+        {
+            double start = nowNs();
+            std::vector<Task *> order = manager.topologicalSort();
+            samples.push_back(nowNs() - start);
+        }
+        results.push_back(summarize("topologicalSort", graph, n, samples, n));
+
+        // The same passes on the frozen CSR copy, on every core
+        unsigned workers = std::max(1u, std::thread::hardware_concurrency());
+        FrozenGraph frozen;
+        samples.clear();
+        for (std::size_t r = 0; r < options.reps; ++r)
+        {
+            double start = nowNs();
+            manager.freezeGraph(frozen, workers);
+            samples.push_back(nowNs() - start);
+        }
+        results.push_back(summarize("freezeGraph", graph, n, samples, n));
+
+        samples.clear();
+        for (std::size_t r = 0; r < options.reps; ++r)
+        {
+            double start = nowNs();
+            std::vector<TaskId> csrOrder = frozen.topologicalOrder(workers);
+            samples.push_back(nowNs() - start);
+        }
+        results.push_back(summarize("csrTopologicalOrder", graph, n, samples, n));
+
+        samples.clear();
+        for (std::size_t r = 0; r < options.reps; ++r)
+        {
+            double start = nowNs();
+            std::vector<TaskId> downstream = frozen.reachable({manager.handleOf(names[0]).id}, GraphDirection::DEPENDENTS, workers);
+            samples.push_back(nowNs() - start);
+        }
+        results.push_back(summarize("reachable", graph, n, samples, n));
+
+        samples.clear();
+        for (std::size_t r = 0; r < options.reps; ++r)
+        {
+            double start = nowNs();
+            manager.displayTasks();
+            samples.push_back(nowNs() - start);
+        }
+        results.push_back(summarize("displayTasks", graph, n, samples, 1));
+
+        // deleteTask in random order
+        std::vector<std::size_t> order(n);
+        for (std::size_t i = 0; i < n; ++i)
+            order[i] = i;
+        std::shuffle(order.begin(), order.end(), rng);
+        samples.clear();
+        samples.reserve(n);
+        for (std::size_t i : order)
+        {
+            double start = nowNs();
+            manager.deleteTask(names[i]);
+            samples.push_back(nowNs() - start);
+        }
+        results.push_back(summarize("deleteTask", graph, n, samples, 1));
+    }
+
+    // Dispatch: the time between consecutive tasks handed out by the
+    // executor on one worker, then a full serial run
+    {
+        TaskManager manager;
+        buildManager(manager, names, edges, rng);
+        samples.clear();
+        samples.reserve(n);
+        double last = nowNs();
+        manager.executeTasksParallel(1, [&](Task &)
+                                     {
+            double now = nowNs();
+            samples.push_back(now - last);
+            last = now; });
+        results.push_back(summarize("dispatch", graph, n, samples, 1));
+    }
+    {
+        TaskManager manager;
+        buildManager(manager, names, edges, rng);
+        samples.clear();
+        double start = nowNs();
+        manager.runReadyTasks();
+        samples.push_back(nowNs() - start);
+        results.push_back(summarize("runReadyTasks", graph, n, samples, n));
+    }
+    {
+        unsigned workers = std::max(1u, std::thread::hardware_concurrency());
+        TaskManager manager;
+        buildManager(manager, names, edges, rng);
+        samples.clear();
+        double start = nowNs();
+        manager.executeTasksParallel(workers);
+        samples.push_back(nowNs() - start);
+        results.push_back(summarize("executeTasksParallel", graph, n, samples, n));
+    }
+}
+
+// Producers on every core submit adds through the concurrent front end and
+// each waits on a call() round trip every few operations. A round trip that
+// outlives the timeout means the owner thread parked with work queued, so
+// it is reported and fails the run rather than hanging it.
+bool benchConcurrent(std::size_t n, std::vector<BenchResult> &results)
+{
+    const unsigned producers = std::max(2u, std::thread::hardware_concurrency());
+    const std::size_t perProducer = std::max<std::size_t>(1, n / producers);
+    const std::size_t callEvery = 16;
+    const auto timeout = std::chrono::seconds(10);
+    TaskManager manager;
+    std::vector<std::vector<double>> perThread(producers);
+    std::atomic<std::size_t> stalled{0};
+    {
+        ConcurrentTaskManager front(manager);
+        std::vector<std::thread> threads;
+        for (unsigned p = 0; p < producers; ++p)
+        {
+            threads.emplace_back([&, p]
+                                 {
+                std::vector<double> &samples = perThread[p];
+                for (std::size_t i = 0; i < perProducer; ++i)
+                {
+                    front.addTask("p" + std::to_string(p) + "_" + std::to_string(i), "benchmark task", static_cast<int>(i % 100), 0.0);
+                    if (i % callEvery != 0)
+                        continue;
+                    double start = nowNs();
+                    std::future<std::size_t> count = front.taskCount();
+                    if (count.wait_for(timeout) != std::future_status::ready)
+                    {
+                        stalled.fetch_add(1);
+                        return;
+                    }
+                    samples.push_back(nowNs() - start);
+                } });
+        }
+        for (std::thread &thread : threads)
+            thread.join();
+        if (stalled.load() == 0 && front.flush().wait_for(timeout) != std::future_status::ready)
+            stalled.fetch_add(1);
+        if (stalled.load() != 0)
+        {
+            // The owner cannot be joined while it is stuck; leave it behind
+            std::fprintf(stderr, "concurrentCall: %zu round trips timed out\n", stalled.load());
+            std::fflush(stderr);
+            std::_Exit(1);
+        }
+    }
+
+    std::vector<double> samples;
+    for (const std::vector<double> &thread : perThread)
+        samples.insert(samples.end(), thread.begin(), thread.end());
+    results.push_back(summarize("concurrentCall", "-", n, samples, 1));
+    if (manager.taskCount() != perProducer * producers)
+    {
+        std::fprintf(stderr, "concurrentCall: %zu of %zu tasks applied\n", manager.taskCount(), perProducer * producers);
+        return false;
+    }
+    return true;
+}
+
+// saveSnapshot and loadSnapshot under the WSJF policy, whose scores depend
+// on task durations. The reloaded manager must report the same priorities
+// and dispatch the tasks in the same order as the one that was saved.
+bool benchSnapshot(const BenchOptions &options, std::size_t n, std::vector<BenchResult> &results)
+{
+    std::mt19937 rng(options.seed);
+    std::uniform_int_distribution<int> deadline(0, 100);
+    std::uniform_int_distribution<int> duration(1, 40);
+    std::vector<std::string> names = taskNames(n);
+    const char *tmp = std::getenv("TMPDIR");
+    std::string path = std::string(tmp && *tmp ? tmp : "/tmp") + "/tm-benchmark-" + std::to_string(::getpid()) + ".snap";
+
+    WsjfTaskManager saved;
+    for (std::size_t i = 0; i < n; ++i)
+        saved.addTask(names[i], "benchmark task", deadline(rng), 0.0, duration(rng));
+
+    std::vector<double> samples;
+    for (std::size_t r = 0; r < options.reps; ++r)
+    {
+        double start = nowNs();
+        saved.saveSnapshot(path);
+        samples.push_back(nowNs() - start);
+    }
+    results.push_back(summarize("saveSnapshot", "wsjf", n, samples, n));
+
+    samples.clear();
+    std::unique_ptr<WsjfTaskManager> loaded;
+    for (std::size_t r = 0; r < options.reps; ++r)
+    {
+        loaded.reset(new WsjfTaskManager());
+        double start = nowNs();
+        bool ok = loaded->loadSnapshot(path);
+        samples.push_back(nowNs() - start);
+        if (!ok)
+        {
+            std::fprintf(stderr, "loadSnapshot: cannot reload '%s'\n", path.c_str());
+            std::remove(path.c_str());
+            return false;
+        }
+    }
+    std::remove(path.c_str());
+    results.push_back(summarize("loadSnapshot", "wsjf", n, samples, n));
+
+    std::size_t mismatched = 0;
+    for (const std::string &name : names)
+    {
+        Task *before = saved.findTask(name);
+        Task *after = loaded->findTask(name);
+        if (!after || after->getPriority() != before->getPriority() || after->getDuration() != before->getDuration())
+            ++mismatched;
+    }
+    std::vector<std::string> savedOrder;
+    std::vector<std::string> loadedOrder;
+    saved.executeTasksParallel(1, [&](Task &task)
+                               { savedOrder.push_back(task.getName()); });
+    loaded->executeTasksParallel(1, [&](Task &task)
+                                 { loadedOrder.push_back(task.getName()); });
+    if (mismatched != 0 || savedOrder != loadedOrder)
+    {
+        std::fprintf(stderr, "loadSnapshot: %zu of %zu priorities differ, dispatch order %s\n", mismatched, n,
+                     savedOrder == loadedOrder ? "matches" : "differs");
+        return false;
+    }
+    return true;
+}
+
+void benchBTree(const BenchOptions &options, std::size_t n, std::vector<BenchResult> &results)
+{
+    std::mt19937 rng(options.seed);
+    std::uniform_int_distribution<int> deadline(0, static_cast<int>(std::min<std::size_t>(n, 1u << 30)));
+    std::vector<int> keys(n);
+    for (int &key : keys)
+        key = deadline(rng);
+    std::vector<double> samples;
+
+    btree::DeadlineIndex index;
+    samples.reserve(n);
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        double start = nowNs();
+        index.insert(keys[i], static_cast<btree::TaskHandle>(i));
+        samples.push_back(nowNs() - start);
+    }
+    results.push_back(summarize("btree.insert", "-", n, samples, 1));
+
+    std::shuffle(keys.begin(), keys.end(), rng);
+    samples.clear();
+    std::size_t found = 0;
+    for (int key : keys)
+    {
+        double start = nowNs();
+        found += index.find(key) != index.end();
+        samples.push_back(nowNs() - start);
+    }
+    results.push_back(summarize("btree.search", "-", n, samples, 1));
+    if (found != n)
+        std::fprintf(stderr, "btree.search: %zu of %zu keys found\n", found, n);
+
+    samples.clear();
+    for (std::size_t r = 0; r < options.reps; ++r)
+    {
+        std::vector<btree::DeadlineIndex::Entry> entries;
+        entries.reserve(n);
+        for (std::size_t i = 0; i < n; ++i)
+            entries.emplace_back(keys[i], static_cast<btree::TaskHandle>(i));
+        btree::DeadlineIndex loaded;
+        double start = nowNs();
+        loaded.bulkLoad(std::move(entries));
+        samples.push_back(nowNs() - start);
+    }
+    results.push_back(summarize("btree.bulkLoad", "-", n, samples, n));
+}
+
+bool parseOptions(int argc, char *argv[], BenchOptions &options)
+{
+    auto split = [](const std::string &list)
+    {
+        std::vector<std::string> items;
+        std::size_t start = 0;
+        while (start <= list.size())
+        {
+            std::size_t comma = list.find(',', start);
+            if (comma == std::string::npos)
+                comma = list.size();
+            if (comma > start)
+                items.push_back(list.substr(start, comma - start));
+            start = comma + 1;
+        }
+        return items;
+    };
+    // A whole number in [min, max] and nothing else
+    auto count = [](const std::string &text, unsigned long long min, unsigned long long max, auto &out)
+    {
+        unsigned long long parsed = 0;
+        auto result = std::from_chars(text.data(), text.data() + text.size(), parsed);
+        if (text.empty() || result.ec != std::errc() || result.ptr != text.data() + text.size() || parsed < min || parsed > max)
+            return false;
+        out = static_cast<std::remove_reference_t<decltype(out)>>(parsed);
+        return true;
+    };
+
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        if (i + 1 >= argc)
+            return false;
+        std::string value = argv[++i];
+        if (arg == "--sizes")
+        {
+            options.sizes.clear();
+            for (const std::string &item : split(value))
+            {
+                // Whole numbers only, written plainly or like 1e5, so neither
+                // 1k nor 1.5 is quietly read as 1
+                char *end = nullptr;
+                double size = std::strtod(item.c_str(), &end);
+                if (*end != '\0' || !(size >= 1.0 && size <= 1e12) || size != std::floor(size))
+                    return false;
+                options.sizes.push_back(static_cast<std::size_t>(size));
+            }
+            if (options.sizes.empty())
+                return false;
+        }
+        else if (arg == "--graph")
+            options.graphs = value == "all" ? std::vector<std::string>{"chain", "fanout", "layered"} : split(value);
+        else if (arg == "--layers")
+        {
+            if (!count(value, 1, 1u << 20, options.layers))
+                return false;
+        }
+        else if (arg == "--degree")
+        {
+            if (!count(value, 0, 1024, options.degree))
+                return false;
+        }
+        else if (arg == "--reps")
+        {
+            if (!count(value, 1, 1u << 20, options.reps))
+                return false;
+        }
+        else if (arg == "--seed")
+        {
+            if (!count(value, 0, std::numeric_limits<unsigned>::max(), options.seed))
+                return false;
+        }
+        else if (arg == "--json")
+            options.jsonPath = value;
+        else
+            return false;
+    }
+    for (const std::string &graph : options.graphs)
+    {
+        if (graph != "chain" && graph != "fanout" && graph != "layered")
+            return false;
+    }
+    return true;
+}
+
+void writeJson(std::FILE *out, const std::vector<BenchResult> &results)
+{
+    std::fprintf(out, "[\n");
+    for (std::size_t i = 0; i < results.size(); ++i)
+    {
+        const BenchResult &r = results[i];
+        std::fprintf(out, "  {\"benchmark\": \"%s\", \"graph\": \"%s\", \"size\": %zu, \"samples\": %zu, \"p50_ns\": %.1f, \"p99_ns\": %.1f, \"ops_per_sec\": %.1f}%s\n",
+                     r.name.c_str(), r.graph.c_str(), r.size, r.samples, r.p50Ns, r.p99Ns, r.opsPerSec, i + 1 < results.size() ? "," : "");
+    }
+    std::fprintf(out, "]\n");
+}
+
+int main(int argc, char *argv[])
+{
+    BenchOptions options;
+    if (!parseOptions(argc, argv, options))
+    {
+        std::fprintf(stderr, "usage: %s [--sizes 1e3,1e4,1e5] [--graph chain|fanout|layered|all] [--layers N] [--degree N] [--reps N] [--seed N] [--json PATH|-]\n", argv[0]);
+        return 2;
+    }
+    const bool jsonToStdout = options.jsonPath == "-";
+
+    // The task manager narrates to std::cout; keep that out of the report
+    NullBuffer discard;
+    std::streambuf *console = std::cout.rdbuf(&discard);
+
+    std::vector<BenchResult> results;
+    bool failed = false;
+    for (std::size_t n : options.sizes)
+    {
+        std::size_t first = results.size();
+        for (const std::string &graph : options.graphs)
+            benchTaskManager(options, graph, n, results);
+        if (!benchConcurrent(n, results))
+            failed = true;
+        if (!benchSnapshot(options, n, results))
+            failed = true;
+        benchBTree(options, n, results);
+
+        if (!jsonToStdout)
+        {
+            for (std::size_t i = first; i < results.size(); ++i)
+            {
+                const BenchResult &r = results[i];
+                std::printf("%-22s %-8s n=%-9zu p50 %12.1f ns  p99 %12.1f ns  %14.1f ops/s\n",
+                            r.name.c_str(), r.graph.c_str(), r.size, r.p50Ns, r.p99Ns, r.opsPerSec);
+            }
+            std::fflush(stdout);
+        }
+    }
+    std::cout.rdbuf(console);
+
+    if (jsonToStdout)
+        writeJson(stdout, results);
+    else if (!options.jsonPath.empty())
+    {
+        std::FILE *out = std::fopen(options.jsonPath.c_str(), "w");
+        if (!out)
+        {
+            std::fprintf(stderr, "cannot write '%s'\n", options.jsonPath.c_str());
+            return 1;
+        }
+        writeJson(out, results);
+        std::fclose(out);
+    }
+    return failed ? 1 : 0;
+}
@@ -1,536 +1,6660 @@
-#include <iostream>
-#include <string>
-#include <unordered_map>
-#include <queue>
-#include <list>
-#include <vector>
-#include <algorithm>
-#include <limits>
-
-using namespace std;
-
-// Forward declaration of Task class
-class Task;
-
-// Dependency graph node
-struct GraphNode
-{
-    Task *task;
-    std::vector<GraphNode *> dependencies;
-};
-
-// Enumeration for task completion status
-enum class CompletionStatus
-{
-    NOT_STARTED,
-    JUST_STARTED,
-    HALF_COMPLETED,
-    ALMOST_COMPLETED,
-    FINISHED
-};
-
-// Task class
-class Task
-{
-private:
-    std::string name;
-    std::string description;
-    int deadline;
-    double priority;
-    double completion;
-    CompletionStatus status;
-    double completionFactor;
-    double deadlineFactor;
-
-public:
-    Task(std::string name, std::string description, int deadline, double completion) : name(name), description(description), deadline(deadline), completion(completion), status(CompletionStatus::NOT_STARTED)
-    {
-        deadlineFactor = calculateDeadlineFactor();
-        completionFactor = completion;
-        priority = calculatePriority();
-    }
-
-    float calculatePriority()
-    {
-        // Calculate priority based on the provided formula
-        std::cout << "deadline : " << deadlineFactor << " -------------------- " << completionFactor << std::endl;
-        float priority = 0.3f * deadlineFactor + 0.7f * completionFactor;
-        return priority;
-    }
-
-    double getPriority() const
-    {
-        return priority;
-    }
-
-    float calculateDeadlineFactor()
-    {
-        // Calculate deadline factor based on the provided formula
-        return 1.0f - (static_cast<float>(deadline) / (deadline + 30));
-    }
-
-    std::string getName() const
-    {
-        return name;
-    }
-
-    std::string getDescription() const
-    {
-        return description;
-    }
-
-    int getDeadline() const
-    {
-        return deadline;
-    }
-
-    float getStatus() const
-    {
-        // Calculate completion status in float
-        // switch (status)
-        // {
-        // case completion:
-        //     return 0.0;
-        // case 0.25:
-        //     return 0.25;
-        // case CompletionStatus::HALF_COMPLETED:
-        //     return 0.5;
-        // case CompletionStatus::ALMOST_COMPLETED:
-        //     return 0.75;
-        // case CompletionStatus::FINISHED:
-        //     return 1.0;
-        // default:
-        //     return 0.0; // Default to NOT_STARTED if status is invalid
-        // }
-
-        return this->completionFactor;
-    }
-
-    void setStatus(CompletionStatus newStatus)
-    {
-        status = newStatus;
-        completionFactor = 1.0 - getStatus();
-    }
-
-    double getCompletionFactor() const
-    {
-        return completionFactor;
-    }
-};
-
-// Comparison function for priority queue
-struct CompareTask
-{
-    bool operator()(const Task *a, const Task *b) const
-    {
-        return a->getPriority() > b->getPriority();
-    }
-};
-
-// Task Manager class
-class TaskManager
-{
-public:
-    std::unordered_map<std::string, Task *> taskMap;
-
-private:
-    std::priority_queue<Task *, std::vector<Task *>, CompareTask> taskQueue; // Priority queue for tasks
-    std::unordered_map<std::string, GraphNode *> dependencyGraph;            // Graph for dependency management
-    std::list<Task *> taskList;                                              // Linked list for dynamic task insertion/deletion
-
-    // Helper function for topological sorting
-    void topologicalSortUtil(GraphNode *node, std::unordered_map<std::string, bool> &visited, std::list<Task *> &sortedTasks)
-    {
-        visited[node->task->getName()] = true;
-        for (auto &dep : node->dependencies)
-        {
-            if (!visited[dep->task->getName()])
-            {
-                topologicalSortUtil(dep, visited, sortedTasks);
-            }
-        }
-        sortedTasks.push_front(node->task);
-    }
-
-    // Perform topological sorting
-    std::list<Task *> topologicalSort()
-    {
-        std::unordered_map<std::string, bool> visited;
-        std::list<Task *> sortedTasks;
-
-        for (auto &pair : dependencyGraph)
-        {
-            visited[pair.first] = false;
-        }
-
-        for (auto &pair : dependencyGraph)
-        {
-            if (!visited[pair.first])
-            {
-                topologicalSortUtil(pair.second, visited, sortedTasks);
-            }
-        }
-
-        return sortedTasks;
-    }
-
-public:
-    void addTask(Task *task)
-    {
-        taskMap[task->getName()] = task;
-        taskList.push_back(task);
-
-        // Push the new task onto the priority queue
-        taskQueue.push(task);
-
-        GraphNode *newNode = new GraphNode();
-        newNode->task = task;
-        dependencyGraph[task->getName()] = newNode;
-    }
-
-    void deleteTask(const std::string &taskName)
-    {
-        // Find the task in the taskMap
-        auto it = taskMap.find(taskName);
-        if (it != taskMap.end())
-        {
-            Task *taskToDelete = it->second;
-
-            // Remove the task from the taskMap
-            taskMap.erase(it);
-
-            // Remove the task from the taskList
-            taskList.remove(taskToDelete);
-
-            // Remove the task from the priority queue taskQueue
-            std::priority_queue<Task *, std::vector<Task *>, CompareTask> newQueue;
-            while (!taskQueue.empty())
-            {
-                Task *currentTask = taskQueue.top();
-                taskQueue.pop();
-                if (currentTask->getName() != taskName)
-                {
-                    newQueue.push(currentTask);
-                }
-            }
-            taskQueue = newQueue;
-
-            // Remove the task from the dependency graph
-            auto depIt = dependencyGraph.find(taskName);
-            if (depIt != dependencyGraph.end())
-            {
-                GraphNode *nodeToDelete = depIt->second;
-                dependencyGraph.erase(depIt);
-
-                // Remove all dependencies on this task from other nodes
-                for (auto &pair : dependencyGraph)
-                {
-                    auto &dependencies = pair.second->dependencies;
-                    dependencies.erase(std::remove_if(dependencies.begin(), dependencies.end(), [taskToDelete](GraphNode *dep)
-                                                      { return dep->task == taskToDelete; }),
-                                       dependencies.end());
-                }
-
-                delete nodeToDelete;
-            }
-
-            // Delete the task object
-            delete taskToDelete;
-
-            std::cout << "Task '" << taskName << "' deleted successfully." << std::endl;
-        }
-        else
-        {
-            std::cout << "Task '" << taskName << "' not found." << std::endl;
-        }
-    }
-
-    // Method to prompt user for task name and delete the task if found
-    void deleteTaskPrompt()
-    {
-        std::string taskNameToDelete;
-        std::cout << "Enter the name of the task to delete: ";
-        std::cin.ignore(); // Ignore any previous newline character
-        std::getline(std::cin, taskNameToDelete);
-
-        auto it = taskMap.find(taskNameToDelete);
-        if (it != taskMap.end())
-        {
-            Task *taskToDelete = it->second;
-
-            // Remove task from taskMap
-            taskMap.erase(it);
-
-            // Remove task from taskQueue
-            std::priority_queue<Task *, std::vector<Task *>, CompareTask> newTaskQueue;
-            while (!taskQueue.empty())
-            {
-                Task *task = taskQueue.top();
-                taskQueue.pop();
-                if (task != taskToDelete)
-                {
-                    newTaskQueue.push(task);
-                }
-                else
-                {
-                    // Delete task object to free memory
-                    delete task;
-                }
-            }
-            taskQueue = newTaskQueue;
-
-            // Remove task from taskList
-            taskList.remove(taskToDelete);
-
-            // Remove task from dependencyGraph
-            auto dependencyIt = dependencyGraph.find(taskNameToDelete);
-            if (dependencyIt != dependencyGraph.end())
-            {
-                delete dependencyIt->second;
-                dependencyGraph.erase(dependencyIt);
-            }
-
-            std::cout << "Task '" << taskNameToDelete << "' has been deleted successfully." << std::endl;
-        }
-        else
-        {
-            std::cout << "Task '" << taskNameToDelete << "' not found. No task was deleted." << std::endl;
-        }
-    }
-
-    // Method to add dependencies between tasks
-    void addDependency(const std::string &taskName, const std::string &dependencyName)
-    {
-        if (dependencyGraph.find(taskName) != dependencyGraph.end() && dependencyGraph.find(dependencyName) != dependencyGraph.end())
-        {
-            dependencyGraph[taskName]->dependencies.push_back(dependencyGraph[dependencyName]);
-            std::cout << "Dependency added successfully!" << std::endl;
-        }
-        else
-        {
-            std::cout << "Task or dependency not found. Please make sure both tasks exist." << std::endl;
-        }
-    }
-
-    // Method to mark task as completed
-    void markTaskCompleted(Task *task, CompletionStatus status)
-    {
-        task->setStatus(status);
-    }
-
-    double getUserCompletionStatus()
-    {
-        std::cout << "Select completion status:" << std::endl;
-        std::cout << "1. Not Started" << std::endl;
-        std::cout << "2. Just Started" << std::endl;
-        std::cout << "3. Half Completed" << std::endl;
-        std::cout << "4. Almost Completed" << std::endl;
-        std::cout << "5. Finished" << std::endl;
-
-        int choice;
-        std::cout << "Enter your choice (1-5): ";
-        std::cin >> choice;
-
-        switch (choice)
-        {
-        case 1:
-            return 0.0;
-        case 2:
-            return 0.25;
-        case 3:
-            return 0.5;
-        case 4:
-            return 0.75;
-        case 5:
-            return 1.0;
-        default:
-            std::cout << "Invalid choice. Defaulting to Not Started." << std::endl;
-            return -1.0;
-        }
-    }
-
-    // Method to add a new task interactively during program execution
-    void addNewTask()
-    {
-        std::string name, description;
-        int deadline;
-
-        std::cin.ignore(); // Ignore the newline character from previous input
-
-        std::cout << "Enter task name: ";
-        std::getline(std::cin, name);
-
-        if (name.empty())
-        {
-            std::cout << "Error: Please enter a name for the task." << std::endl;
-            return; // Or handle the empty name case differently
-        }
-
-        std::cout << "Enter task description: ";
-        std::getline(std::cin, description);
-
-        std::cout << "Enter task deadline: ";
-        std::cin >> deadline;
-        std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n'); // Clear the input buffer
-
-        Task *newTask = new Task(name, description, deadline, getUserCompletionStatus());
-        if (newTask == nullptr)
-        {
-            std::cerr << "Error: Memory allocation failed for new task." << std::endl;
-            return;
-        }
-        addTask(newTask);
-
-        displayTasks(); // Display all tasks after adding the new task
-    }
-
-    // Perform topological sorting and execute tasks accordingly
-    void executeTasks()
-    {
-        while (true)
-        {
-            std::priority_queue<Task *, std::vector<Task *>, CompareTask> sortedTasksQueue;
-            while (!taskQueue.empty())
-            {
-                sortedTasksQueue.push(taskQueue.top());
-                taskQueue.pop();
-            }
-
-            while (!sortedTasksQueue.empty())
-            {
-                Task *task = sortedTasksQueue.top();
-                sortedTasksQueue.pop();
-                std::cout << "Executing task: " << task->getName() << std::endl;
-
-                // Prompt user for completion status
-                // CompletionStatus status = getUserCompletionStatus();
-                // markTaskCompleted(task, status);
-            }
-
-            displayTasks();
-
-            std::cout << "Select an option:" << std::endl;
-            std::cout << "1. Add Task" << std::endl;
-            std::cout << "2. Delete Task" << std::endl;
-            std::cout << "3. View Tasks" << std::endl;
-            std::cout << "4. Exit" << std::endl;
-
-            int option;
-            std::cout << "Enter your choice (1-4): ";
-            std::cin >> option;
-
-            std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n'); // Clear the input buffer
-
-            switch (option)
-            {
-            case 1:
-                addNewTask();
-                break;
-            case 2:
-                deleteTaskPrompt();
-                break;
-            case 3:
-                displayTasks();
-                break;
-            case 4:
-                std::cout << "Exiting the program." << std::endl;
-                return;
-            default:
-                std::cout << "Invalid option. Please try again." << std::endl;
-                break;
-            }
-        }
-    }
-
-    // Method to display all task details sorted by priority
-    void displayTasks()
-    {
-        // Create a copy of taskList
-        std::list<Task *> taskListCopy = taskList;
-
-        // Sort the copy of taskList by priority
-        std::vector<Task *> allTasks(taskListCopy.begin(), taskListCopy.end());
-        std::sort(allTasks.begin(), allTasks.end(), [](Task *a, Task *b)
-                  { return a->getPriority() > b->getPriority(); });
-
-        std::cout << "All Tasks (Sorted by Priority):\n";
-        for (auto &task : allTasks)
-        {
-            std::cout << "Name: " << task->getName() << ", Description: " << task->getDescription() << ", Deadline: " << task->getDeadline() << ", Status: ";
-            float completionStatus = task->getStatus();
-            if (completionStatus == 0.0)
-                std::cout << "Not started";
-            else if (completionStatus == 0.25)
-                std::cout << "Just started";
-            else if (completionStatus == 0.5)
-                std::cout << "Half completed";
-            else if (completionStatus == 0.75)
-                std::cout << "Almost completed";
-            else if (completionStatus == 1.0)
-                std::cout << "Finished";
-            else
-                std::cout << "Unknown";
-
-            std::cout << "Priority: " << task->getPriority() << std::endl;
-        }
-    }
-
-    // Method to prompt user for dependency and add it
-    void addDependencyPrompt()
-    {
-        std::string taskName;
-        std::string dependencyName;
-        std::cout << "Enter the name of the task: ";
-        std::cin >> taskName;
-        std::cout << "Enter the name of the dependency task: ";
-        std::cin >> dependencyName;
-        addDependency(taskName, dependencyName);
-    }
-};
-
-int main()
-{
-    TaskManager taskManager;
-
-    // Prompt user to create tasks
-    int numTasks;
-    std::cout << "Enter the number of tasks: ";
-    std::cin >> numTasks;
-    std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n'); // Clear the input buffer
-
-    for (int i = 0; i < numTasks; ++i)
-    {
-        std::string name, description;
-        int deadline;
-
-        std::cout << "Enter task name: ";
-        std::getline(std::cin, name);
-
-        std::cout << "Enter task description: ";
-        std::getline(std::cin, description);
-
-        std::cout << "Enter task deadline: ";
-        std::cin >> deadline;
-
-        double completion = taskManager.getUserCompletionStatus();
-        cout << "Completion : " << completion << std::endl;
-        std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n'); // Clear the input buffer
-        Task *newTask = new Task(name, description, deadline, completion);
-        taskManager.addTask(newTask);
-    }
-
-    // Prompt user to add dependencies
-    char addDependencies;
-    std::cout << "Do you want to add dependencies between tasks? (Y/N): ";
-    std::cin >> addDependencies;
-
-    if (addDependencies == 'Y' || addDependencies == 'y')
-    {
-        taskManager.addDependencyPrompt();
-    }
-
-    // Execute tasks
-    taskManager.executeTasks();
-
-    return 0;
-}
\ No newline at end of file
+#include <iostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <algorithm>
+#include <limits>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <charconv>
+#include <new>
+#include <string_view>
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
+#include <future>
+#include <type_traits>
+#include <cerrno>
+#include <cmath>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <csignal>
+#include <unordered_set>
+#include <utility>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+#if defined(__AVX__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+// Coroutine task bodies need a C++20 compiler
+#if defined(__cpp_impl_coroutine) && __has_include(<coroutine>)
+#include <coroutine>
+#include <sys/eventfd.h>
+#define TM_HAS_COROUTINES
+#endif
+
+using namespace std;
+
+// Forward declaration of Task class
+class Task;
+
+// Slot value for elements that are not currently stored in a heap
+constexpr std::size_t kNoHeapSlot = static_cast<std::size_t>(-1);
+
+// Dense task identifier, shared by the Task and GraphNode arenas
+using TaskId = std::uint32_t;
+constexpr TaskId kInvalidTaskId = std::numeric_limits<TaskId>::max();
+
+// Generation-checked reference to a task. A handle to a deleted task stays
+// invalid even after its id has been reused for a new task.
+struct TaskHandle
+{
+    TaskId id = kInvalidTaskId;
+    std::uint32_t generation = 0;
+
+    bool valid() const
+    {
+        return id != kInvalidTaskId;
+    }
+};
+
+// Dependency graph node
+struct GraphNode
+{
+    Task *task;
+    std::vector<GraphNode *> dependencies;
+    std::vector<GraphNode *> dependents;  // Reverse edges: tasks waiting on this one
+    int pendingDependencies = 0;          // Dependencies that have not finished yet
+    bool completed = false;               // Set once the scheduler has executed the task
+    std::size_t readySlot = kNoHeapSlot;  // Position inside the ready queue
+    TaskId id = kInvalidTaskId;           // Dense id, also the index of the owning Task
+    std::size_t livePos = 0;              // Position inside TaskManager::liveTasks
+    std::size_t topoIndex = 0;            // Position in the incrementally maintained topological order
+    unsigned visitMark = 0;               // Epoch stamp used by graph searches instead of a visited map
+    std::int64_t earliestStart = 0;       // Schedule analysis: all dependencies finished
+    std::int64_t earliestFinish = 0;
+    std::int64_t latestStart = 0;         // Schedule analysis: last start that meets every deadline downstream
+    std::int64_t latestFinish = 0;
+};
+
+// Enumeration for task completion status
+enum class CompletionStatus
+{
+    NOT_STARTED,
+    JUST_STARTED,
+    HALF_COMPLETED,
+    ALMOST_COMPLETED,
+    FINISHED
+};
+
+// Priority weights shared by Task and the batch re-scoring kernel
+constexpr float kDeadlineWeight = 0.3f;
+constexpr float kCompletionWeight = 0.7f;
+constexpr float kDeadlineHorizon = 30.0f;
+
+// Estimated duration, in clock units, of a task added without one
+constexpr int kDefaultDuration = 1;
+
+// Clock units before its deadline at which a task counts as approaching it
+constexpr int kDeadlineWarningLead = 10;
+
+// Fired by the deadline timers of unfinished tasks
+enum class DeadlineEvent
+{
+    APPROACHING, // Within kDeadlineWarningLead units of the deadline
+    OVERDUE      // The clock has passed the deadline
+};
+
+// Remaining time is rounded down to an aging band before it is scored:
+// exact below 16 units, then 8 bands per doubling. Masking a float to its
+// sign, exponent and top three mantissa bits does exactly that, so a score
+// only changes when its task crosses into the next band.
+constexpr std::uint32_t kAgingBandMask = 0xFFF00000u;
+
+inline float agingBand(float remaining)
+{
+    std::uint32_t bits;
+    std::memcpy(&bits, &remaining, sizeof(bits));
+    bits &= kAgingBandMask;
+    std::memcpy(&remaining, &bits, sizeof(bits));
+    return remaining;
+}
+
+// Deadline urgency in (0, 1]: 1 when due now, 0.5 when due in kDeadlineHorizon units
+inline float deadlineFactorFor(float remaining)
+{
+    return kDeadlineHorizon / (agingBand(std::max(remaining, 0.0f)) + kDeadlineHorizon);
+}
+
+// a * b + c * d, rounded identically by the scalar and SIMD scoring paths:
+// one fused multiply-add where the target has FMA, separate steps otherwise,
+// so the compiler cannot contract one path and not the other
+inline float weightedSum(float a, float b, float c, float d)
+{
+#if defined(__FMA__)
+    return std::fma(a, b, c * d);
+#else
+    return a * b + c * d;
+#endif
+}
+
+// Marks a task whose score no longer ages (it is overdue)
+constexpr int kNeverAges = std::numeric_limits<int>::max();
+
+// First clock value after now at which the aging band of a task due at
+// deadline changes
+inline int nextAgingTime(int deadline, int now)
+{
+    if (deadline <= now)
+        return kNeverAges;
+    int bandStart = static_cast<int>(agingBand(static_cast<float>(deadline - now)));
+    return deadline - bandStart + 1;
+}
+
+// Task class
+class Task
+{
+private:
+    std::string name;
+    std::string description;
+    int deadline;
+    float priority;
+    double completion;
+    CompletionStatus status;
+    float completionFactor;
+    float deadlineFactor;
+    int duration = kDefaultDuration;     // Estimated clock units of work
+    bool approaching = false;            // Set by the APPROACHING deadline event
+    bool overdue = false;                // Set by the OVERDUE deadline event
+    std::size_t queueSlot = kNoHeapSlot; // Position inside the TaskManager priority queue
+    TaskId taskId = kInvalidTaskId;      // Assigned by the owning TaskManager
+
+    template <typename Policy>
+    friend class BasicTaskManager;
+
+public:
+    // The priority is scored by the policy of the TaskManager that owns the task
+    Task(std::string name, std::string description, int deadline, double completion) : name(std::move(name)), description(std::move(description)), deadline(deadline), priority(0.0f), completion(completion), status(CompletionStatus::NOT_STARTED)
+    {
+        deadlineFactor = calculateDeadlineFactor();
+        completionFactor = static_cast<float>(completion);
+    }
+
+    float getPriority() const
+    {
+        return priority;
+    }
+
+    // Deadline factor for the time remaining until the deadline at clock value now
+    float calculateDeadlineFactor(int now = 0) const
+    {
+        return deadlineFactorFor(static_cast<float>(deadline - now));
+    }
+
+    const std::string &getName() const
+    {
+        return name;
+    }
+
+    TaskId getId() const
+    {
+        return taskId;
+    }
+
+    const std::string &getDescription() const
+    {
+        return description;
+    }
+
+    int getDeadline() const
+    {
+        return deadline;
+    }
+
+    int getDuration() const
+    {
+        return duration;
+    }
+
+    bool isApproachingDeadline() const
+    {
+        return approaching;
+    }
+
+    bool isOverdue() const
+    {
+        return overdue;
+    }
+
+    float getStatus() const
+    {
+        // Calculate completion status in float
+        // switch (status)
+        // {
+        // case completion:
+        //     return 0.0;
+        // case 0.25:
+        //     return 0.25;
+        // case CompletionStatus::HALF_COMPLETED:
+        //     return 0.5;
+        // case CompletionStatus::ALMOST_COMPLETED:
+        //     return 0.75;
+        // case CompletionStatus::FINISHED:
+        //     return 1.0;
+        // default:
+        //     return 0.0; // Default to NOT_STARTED if status is invalid
+        // }
+
+        return this->completionFactor;
+    }
+
+    // Map a completion status onto the completion fraction used for scoring
+    static double completionForStatus(CompletionStatus s)
+    {
+        switch (s)
+        {
+        case CompletionStatus::JUST_STARTED:
+            return 0.25;
+        case CompletionStatus::HALF_COMPLETED:
+            return 0.5;
+        case CompletionStatus::ALMOST_COMPLETED:
+            return 0.75;
+        case CompletionStatus::FINISHED:
+            return 1.0;
+        default:
+            return 0.0;
+        }
+    }
+
+    // Update the status; the owner must re-score the task and re-key any
+    // heap holding it afterwards
+    void setStatus(CompletionStatus newStatus)
+    {
+        status = newStatus;
+        completion = completionForStatus(newStatus);
+        completionFactor = static_cast<float>(completion);
+    }
+
+    float getCompletionFactor() const
+    {
+        return completionFactor;
+    }
+
+    float getDeadlineFactor() const
+    {
+        return deadlineFactor;
+    }
+
+    std::size_t &heapSlot()
+    {
+        return queueSlot;
+    }
+};
+
+// Priority policies. TaskManager is a template over one of these, so the
+// scorer and the comparator are inlined into every heap operation. A
+// policy provides
+//   name          identifier accepted by --policy
+//   score(task)   the value stored as the task priority and shown to users
+//   before(a, b)  true when a must be dispatched ahead of b
+//   linear        true when score is deadlineWeight * deadline factor +
+//                 completionWeight * completion factor, which lets batch
+//                 re-scoring use the SIMD kernel
+
+// The original formula, 0.3 * deadline urgency + 0.7 * completion, with
+// the lowest score dispatched first
+struct LegacyPolicy
+{
+    static constexpr const char *name = "legacy";
+    static constexpr bool linear = true;
+    static constexpr float deadlineWeight = kDeadlineWeight;
+    static constexpr float completionWeight = kCompletionWeight;
+
+    static float score(const Task &task)
+    {
+        return weightedSum(deadlineWeight, task.getDeadlineFactor(), completionWeight, task.getCompletionFactor());
+    }
+
+    static bool before(const Task &a, const Task &b)
+    {
+        return a.getPriority() < b.getPriority();
+    }
+};
+
+// Earliest deadline first; of two tasks due together the one further
+// along goes first. The score is the deadline urgency alone.
+struct EdfPolicy
+{
+    static constexpr const char *name = "edf";
+    static constexpr bool linear = true;
+    static constexpr float deadlineWeight = 1.0f;
+    static constexpr float completionWeight = 0.0f;
+
+    static float score(const Task &task)
+    {
+        return task.getDeadlineFactor();
+    }
+
+    static bool before(const Task &a, const Task &b)
+    {
+        if (a.getDeadline() != b.getDeadline())
+            return a.getDeadline() < b.getDeadline();
+        return a.getCompletionFactor() > b.getCompletionFactor();
+    }
+};
+
+// Weighted shortest job first: cost of delay (the deadline urgency)
+// divided by the work still left, highest first, so short urgent tasks
+// jump ahead of long ones due at the same time
+struct WsjfPolicy
+{
+    static constexpr const char *name = "wsjf";
+    static constexpr bool linear = false;
+    static constexpr float minJobSize = 0.25f; // Keeps finished and zero-length jobs finite
+
+    static float score(const Task &task)
+    {
+        float remaining = static_cast<float>(task.getDuration()) * (1.0f - task.getCompletionFactor());
+        return task.getDeadlineFactor() / std::max(remaining, minJobSize);
+    }
+
+    static bool before(const Task &a, const Task &b)
+    {
+        return a.getPriority() > b.getPriority();
+    }
+};
+
+// Call fn with a value of the prebuilt policy called name; false if there
+// is no such policy
+template <typename Fn>
+bool dispatchPolicy(std::string_view name, Fn &&fn)
+{
+    if (name == LegacyPolicy::name)
+        fn(LegacyPolicy());
+    else if (name == EdfPolicy::name)
+        fn(EdfPolicy());
+    else if (name == WsjfPolicy::name)
+        fn(WsjfPolicy());
+    else
+        return false;
+    return true;
+}
+
+// Comparison function for priority queue
+template <typename Policy>
+struct CompareTask
+{
+    bool operator()(const Task *a, const Task *b) const
+    {
+        return Policy::before(*b, *a);
+    }
+};
+
+// Addressable d-ary heap. Every element remembers its slot (through SlotOf),
+// so a single element can be erased or re-keyed in O(log n) instead of
+// draining and rebuilding the whole queue. Ordering follows the
+// std::priority_queue convention: top() is an element x for which
+// comp(x, y) is false for every other y.
+template <typename T, typename Compare, typename SlotOf, std::size_t Arity = 4>
+class IndexedHeap
+{
+private:
+    std::vector<T> items;
+    Compare comp;
+    SlotOf slotOf;
+
+    void place(std::size_t index, T item)
+    {
+        items[index] = item;
+        slotOf(item) = index;
+    }
+
+    void siftUp(std::size_t index)
+    {
+        T item = items[index];
+        while (index > 0)
+        {
+            std::size_t parent = (index - 1) / Arity;
+            if (!comp(items[parent], item))
+                break;
+            place(index, items[parent]);
+            index = parent;
+        }
+        place(index, item);
+    }
+
+    void siftDown(std::size_t index)
+    {
+        T item = items[index];
+        const std::size_t count = items.size();
+        while (true)
+        {
+            std::size_t first = index * Arity + 1;
+            if (first >= count)
+                break;
+            std::size_t last = std::min(first + Arity, count);
+            std::size_t best = first;
+            for (std::size_t child = first + 1; child < last; ++child)
+            {
+                if (comp(items[best], items[child]))
+                    best = child;
+            }
+            if (!comp(item, items[best]))
+                break;
+            place(index, items[best]);
+            index = best;
+        }
+        place(index, item);
+    }
+
+public:
+    bool empty() const
+    {
+        return items.empty();
+    }
+
+    std::size_t size() const
+    {
+        return items.size();
+    }
+
+    std::size_t capacity() const
+    {
+        return items.capacity();
+    }
+
+    T top() const
+    {
+        return items.front();
+    }
+
+    bool contains(T item) const
+    {
+        std::size_t slot = slotOf(item);
+        return slot < items.size() && items[slot] == item;
+    }
+
+    void push(T item)
+    {
+        items.push_back(item);
+        siftUp(items.size() - 1);
+    }
+
+    // Append without restoring heap order; call rebuild() before the next query
+    void pushUnordered(T item)
+    {
+        items.push_back(item);
+        slotOf(item) = items.size() - 1;
+    }
+
+    void reserve(std::size_t count)
+    {
+        items.reserve(count);
+    }
+
+    void clear()
+    {
+        for (T item : items)
+            slotOf(item) = kNoHeapSlot;
+        items.clear();
+    }
+
+    void pop()
+    {
+        erase(items.front());
+    }
+
+    // Remove an arbitrary element in O(log n)
+    void erase(T item)
+    {
+        if (!contains(item))
+            return;
+        std::size_t slot = slotOf(item);
+        slotOf(item) = kNoHeapSlot;
+        T last = items.back();
+        items.pop_back();
+        if (slot == items.size())
+            return;
+        place(slot, last);
+        update(last);
+    }
+
+    // Restore heap order for every element at once (Floyd heapify, O(n)),
+    // used after a batch changed many keys
+    void rebuild()
+    {
+        for (std::size_t i = items.size() / Arity + 1; i-- > 0;)
+        {
+            if (i < items.size())
+                siftDown(i);
+        }
+    }
+
+    // Restore heap order after the key of an element changed in either direction
+    void update(T item)
+    {
+        if (!contains(item))
+            return;
+        std::size_t slot = slotOf(item);
+        if (slot > 0 && comp(items[(slot - 1) / Arity], item))
+            siftUp(slot);
+        else
+            siftDown(slot);
+    }
+};
+
+// Heap slot accessor for tasks stored in the TaskManager priority queue
+struct TaskQueueSlot
+{
+    std::size_t &operator()(Task *task) const
+    {
+        return task->heapSlot();
+    }
+};
+
+// Orders graph nodes by the priority of their tasks
+template <typename Policy>
+struct CompareNode
+{
+    bool operator()(const GraphNode *a, const GraphNode *b) const
+    {
+        return CompareTask<Policy>()(a->task, b->task);
+    }
+};
+
+// Heap slot accessor for nodes stored in the scheduler ready queue
+struct ReadyQueueSlot
+{
+    std::size_t &operator()(GraphNode *node) const
+    {
+        return node->readySlot;
+    }
+};
+
+// Per-worker deque for the parallel executor (Chase-Lev). The owner pushes
+// and pops at the back without locking; idle workers steal from the front
+// with one CAS on top. Outgrown rings are kept until the deque is destroyed
+// because a thief may still be reading one.
+class WorkStealingDeque
+{
+private:
+    struct Ring
+    {
+        std::int64_t mask;
+        std::unique_ptr<std::atomic<GraphNode *>[]> slots;
+
+        explicit Ring(std::int64_t capacity) : mask(capacity - 1), slots(new std::atomic<GraphNode *>[capacity])
+        {
+        }
+
+        GraphNode *get(std::int64_t i) const
+        {
+            return slots[i & mask].load(std::memory_order_relaxed);
+        }
+
+        void put(std::int64_t i, GraphNode *node)
+        {
+            slots[i & mask].store(node, std::memory_order_relaxed);
+        }
+    };
+
+    alignas(64) std::atomic<std::int64_t> top{0}; // Next index to steal
+    alignas(64) std::atomic<std::int64_t> bottom{0}; // Next index to push
+    std::atomic<Ring *> ring;
+    std::vector<std::unique_ptr<Ring>> rings; // Owner only
+
+public:
+    WorkStealingDeque()
+    {
+        rings.emplace_back(new Ring(64));
+        ring.store(rings.back().get(), std::memory_order_relaxed);
+    }
+
+    WorkStealingDeque(const WorkStealingDeque &) = delete;
+    WorkStealingDeque &operator=(const WorkStealingDeque &) = delete;
+
+    // Owner only
+    void pushBack(GraphNode *node)
+    {
+        std::int64_t b = bottom.load(std::memory_order_relaxed);
+        std::int64_t t = top.load(std::memory_order_acquire);
+        Ring *current = ring.load(std::memory_order_relaxed);
+        if (b - t > current->mask)
+        {
+            Ring *grown = new Ring(2 * (current->mask + 1));
+            for (std::int64_t i = t; i < b; ++i)
+                grown->put(i, current->get(i));
+            rings.emplace_back(grown);
+            ring.store(grown, std::memory_order_release);
+            current = grown;
+        }
+        current->put(b, node);
+        bottom.store(b + 1, std::memory_order_release);
+    }
+
+    // Owner only. Claims the last element by lowering bottom first, and
+    // races thieves with a CAS on top only when one element is left.
+    bool popBack(GraphNode *&node)
+    {
+        std::int64_t b = bottom.load(std::memory_order_relaxed) - 1;
+        Ring *current = ring.load(std::memory_order_relaxed);
+        bottom.store(b, std::memory_order_seq_cst);
+        std::int64_t t = top.load(std::memory_order_seq_cst);
+        if (t > b)
+        {
+            bottom.store(b + 1, std::memory_order_relaxed);
+            return false;
+        }
+        GraphNode *last = current->get(b);
+        if (t == b)
+        {
+            bool won = top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+            bottom.store(b + 1, std::memory_order_relaxed);
+            if (!won)
+                return false;
+        }
+        node = last;
+        return true;
+    }
+
+    bool stealFront(GraphNode *&node)
+    {
+        std::int64_t t = top.load(std::memory_order_seq_cst);
+        std::int64_t b = bottom.load(std::memory_order_seq_cst);
+        if (t >= b)
+            return false;
+        GraphNode *first = ring.load(std::memory_order_acquire)->get(t);
+        if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+            return false;
+        node = first;
+        return true;
+    }
+};
+
+// Summary of one parallel execution run
+struct ParallelRunStats
+{
+    std::size_t executed = 0;
+    std::size_t steals = 0;
+    unsigned workers = 0;
+    double makespanMs = 0.0;
+    double utilization = 0.0; // Busy time divided by workers * makespan
+};
+
+// Slab-backed object storage addressed by TaskId. Objects live in
+// fixed-size slabs, so their addresses stay stable while the arena grows
+// and creating a task costs no individual heap allocation. The owner
+// tracks which ids are live.
+template <typename T, std::size_t SlabSize = 4096>
+class SlabArena
+{
+private:
+    struct alignas(T) Slot
+    {
+        unsigned char bytes[sizeof(T)];
+    };
+    std::vector<std::unique_ptr<Slot[]>> slabs;
+
+public:
+    SlabArena() = default;
+    SlabArena(const SlabArena &) = delete;
+    SlabArena &operator=(const SlabArena &) = delete;
+
+    T *at(TaskId id) const
+    {
+        return std::launder(reinterpret_cast<T *>(slabs[id / SlabSize][id % SlabSize].bytes));
+    }
+
+    template <typename... Args>
+    T *emplace(TaskId id, Args &&...args)
+    {
+        while (slabs.size() <= id / SlabSize)
+            slabs.emplace_back(new Slot[SlabSize]);
+        return new (slabs[id / SlabSize][id % SlabSize].bytes) T(std::forward<Args>(args)...);
+    }
+
+    void destroy(TaskId id)
+    {
+        at(id)->~T();
+    }
+
+    std::size_t capacity() const
+    {
+        return slabs.size() * SlabSize;
+    }
+};
+
+// Structure-of-arrays copy of the numeric task fields, indexed by TaskId,
+// so batch re-scoring streams through contiguous floats
+struct TaskColumns
+{
+    std::vector<float> deadline;
+    std::vector<float> completion;
+    std::vector<float> deadlineFactor;
+    std::vector<float> priority;
+
+    void resize(std::size_t count)
+    {
+        deadline.resize(count);
+        completion.resize(count);
+        deadlineFactor.resize(count);
+        priority.resize(count);
+    }
+
+    std::size_t size() const
+    {
+        return deadline.size();
+    }
+};
+
+// Recompute deadlineFactor for every row at clock value now, and the
+// priority too when the policy is linear. Uses AVX or SSE when the
+// compiler targets them, with a scalar tail and fallback that matches
+// Policy::score.
+template <typename Policy>
+void rescoreColumns(TaskColumns &columns, float now)
+{
+    const std::size_t count = columns.size();
+    const float *deadline = columns.deadline.data();
+    const float *completion = columns.completion.data();
+    float *factor = columns.deadlineFactor.data();
+    float *priority = columns.priority.data();
+    std::size_t i = 0;
+
+#if defined(__AVX__)
+    const __m256 nowV = _mm256_set1_ps(now);
+    const __m256 zeroV = _mm256_setzero_ps();
+    const __m256 horizonV = _mm256_set1_ps(kDeadlineHorizon);
+    const __m256 bandMaskV = _mm256_castsi256_ps(_mm256_set1_epi32(static_cast<int>(kAgingBandMask)));
+    for (; i + 8 <= count; i += 8)
+    {
+        __m256 remaining = _mm256_max_ps(_mm256_sub_ps(_mm256_loadu_ps(deadline + i), nowV), zeroV);
+        remaining = _mm256_and_ps(remaining, bandMaskV);
+        __m256 f = _mm256_div_ps(horizonV, _mm256_add_ps(remaining, horizonV));
+        _mm256_storeu_ps(factor + i, f);
+        if constexpr (Policy::linear)
+        {
+            __m256 c = _mm256_mul_ps(_mm256_set1_ps(Policy::completionWeight), _mm256_loadu_ps(completion + i));
+#if defined(__FMA__)
+            __m256 p = _mm256_fmadd_ps(_mm256_set1_ps(Policy::deadlineWeight), f, c);
+#else
+            __m256 p = _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(Policy::deadlineWeight), f), c);
+#endif
+            _mm256_storeu_ps(priority + i, p);
+        }
+    }
+#elif defined(__SSE2__)
+    const __m128 nowV = _mm_set1_ps(now);
+    const __m128 zeroV = _mm_setzero_ps();
+    const __m128 horizonV = _mm_set1_ps(kDeadlineHorizon);
+    const __m128 bandMaskV = _mm_castsi128_ps(_mm_set1_epi32(static_cast<int>(kAgingBandMask)));
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128 remaining = _mm_max_ps(_mm_sub_ps(_mm_loadu_ps(deadline + i), nowV), zeroV);
+        remaining = _mm_and_ps(remaining, bandMaskV);
+        __m128 f = _mm_div_ps(horizonV, _mm_add_ps(remaining, horizonV));
+        _mm_storeu_ps(factor + i, f);
+        if constexpr (Policy::linear)
+        {
+            __m128 p = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(Policy::deadlineWeight), f),
+                                  _mm_mul_ps(_mm_set1_ps(Policy::completionWeight), _mm_loadu_ps(completion + i)));
+            _mm_storeu_ps(priority + i, p);
+        }
+    }
+#endif
+
+    for (; i < count; ++i)
+    {
+        factor[i] = deadlineFactorFor(deadline[i] - now);
+        if constexpr (Policy::linear)
+            priority[i] = weightedSum(Policy::deadlineWeight, factor[i], Policy::completionWeight, completion[i]);
+    }
+}
+
+// Interning table from task name to id. Keys are views of the name stored
+// inside the Task, so each name is kept exactly once. Open addressing with
+// linear probing keeps the hash, the view and the id in one flat slot,
+// so a lookup costs one probe run plus one string compare instead of a
+// chain of node allocations.
+class NameTable
+{
+private:
+    struct Slot
+    {
+        std::size_t hash = 0;
+        std::string_view name;
+        TaskId id = kInvalidTaskId; // kInvalidTaskId marks an empty slot
+    };
+    std::vector<Slot> slots; // Size is zero or a power of two
+    std::size_t count = 0;
+
+    std::size_t mask() const
+    {
+        return slots.size() - 1;
+    }
+
+    std::size_t locate(std::string_view name, std::size_t hash) const
+    {
+        std::size_t i = hash & mask();
+        while (slots[i].id != kInvalidTaskId && (slots[i].hash != hash || slots[i].name != name))
+            i = (i + 1) & mask();
+        return i;
+    }
+
+    void rehash(std::size_t capacity)
+    {
+        std::vector<Slot> old;
+        old.swap(slots);
+        slots.resize(capacity);
+        for (const Slot &slot : old)
+        {
+            if (slot.id != kInvalidTaskId)
+                slots[locate(slot.name, slot.hash)] = slot;
+        }
+    }
+
+public:
+    TaskId find(std::string_view name) const
+    {
+        if (slots.empty())
+            return kInvalidTaskId;
+        return slots[locate(name, std::hash<std::string_view>()(name))].id;
+    }
+
+    bool insert(std::string_view name, TaskId id)
+    {
+        if ((count + 1) * 4 > slots.size() * 3)
+            rehash(std::max<std::size_t>(16, slots.size() * 2));
+        std::size_t hash = std::hash<std::string_view>()(name);
+        Slot &slot = slots[locate(name, hash)];
+        if (slot.id != kInvalidTaskId)
+            return false;
+        slot.hash = hash;
+        slot.name = name;
+        slot.id = id;
+        ++count;
+        return true;
+    }
+
+    // Backward-shift deletion keeps probe runs intact without tombstones
+    void erase(std::string_view name)
+    {
+        if (slots.empty())
+            return;
+        std::size_t hole = locate(name, std::hash<std::string_view>()(name));
+        if (slots[hole].id == kInvalidTaskId)
+            return;
+        --count;
+        for (std::size_t next = (hole + 1) & mask(); slots[next].id != kInvalidTaskId; next = (next + 1) & mask())
+        {
+            std::size_t home = slots[next].hash & mask();
+            // Move the entry back unless its home lies cyclically in (hole, next]
+            bool stays = hole <= next ? (home > hole && home <= next) : (home > hole || home <= next);
+            if (!stays)
+            {
+                slots[hole] = slots[next];
+                hole = next;
+            }
+        }
+        slots[hole] = Slot();
+    }
+
+    void reserve(std::size_t entries)
+    {
+        std::size_t capacity = 16;
+        while (capacity * 3 < entries * 4)
+            capacity *= 2;
+        if (capacity > slots.size())
+            rehash(capacity);
+    }
+
+    std::size_t memoryBytes() const
+    {
+        return slots.capacity() * sizeof(Slot);
+    }
+};
+
+// Hierarchical timing wheel (Varghese and Lauck). Four levels of 256
+// slots cover the whole 32-bit clock; a timer sits at the level of the
+// highest byte in which its expiry differs from the current time, so it
+// is cascaded one level down at most three times before it fires. Timers
+// are keyed by a small dense integer and linked through an array indexed
+// by that key, which makes schedule and cancel O(1). advance() jumps
+// straight to the next occupied slot, so idle stretches of the clock cost
+// nothing.
+class TimingWheel
+{
+private:
+    static constexpr int kLevels = 4;
+    static constexpr int kSlotBits = 8;
+    static constexpr int kSlots = 1 << kSlotBits;
+    static constexpr std::uint32_t kNone = std::numeric_limits<std::uint32_t>::max();
+
+    struct Timer
+    {
+        std::uint32_t when = 0;
+        std::uint32_t prev = kNone;
+        std::uint32_t next = kNone;
+        std::uint32_t slot = kNone; // level * kSlots + slot index, kNone when not armed
+    };
+
+    std::vector<Timer> timers; // Indexed by key
+    std::uint32_t heads[kLevels * kSlots];
+    std::uint64_t occupied[kLevels][kSlots / 64] = {};
+    std::uint32_t now = 0; // Current time, biased so that signed order becomes unsigned order
+    std::size_t armed = 0;
+
+    static std::uint32_t bias(int time)
+    {
+        return static_cast<std::uint32_t>(time) ^ 0x80000000u;
+    }
+
+    void link(std::uint32_t key)
+    {
+        Timer &timer = timers[key];
+        std::uint32_t diff = timer.when ^ now;
+        int level = diff == 0 ? 0 : (31 - __builtin_clz(diff)) / kSlotBits;
+        std::uint32_t index = (timer.when >> (level * kSlotBits)) & (kSlots - 1);
+        timer.slot = static_cast<std::uint32_t>(level * kSlots) + index;
+        timer.prev = kNone;
+        timer.next = heads[timer.slot];
+        if (timer.next != kNone)
+            timers[timer.next].prev = key;
+        heads[timer.slot] = key;
+        occupied[level][index / 64] |= std::uint64_t(1) << (index % 64);
+    }
+
+    void unlink(std::uint32_t key)
+    {
+        Timer &timer = timers[key];
+        if (timer.prev != kNone)
+            timers[timer.prev].next = timer.next;
+        else
+            heads[timer.slot] = timer.next;
+        if (timer.next != kNone)
+            timers[timer.next].prev = timer.prev;
+        if (heads[timer.slot] == kNone)
+        {
+            std::uint32_t level = timer.slot / kSlots, index = timer.slot % kSlots;
+            occupied[level][index / 64] &= ~(std::uint64_t(1) << (index % 64));
+        }
+        timer.slot = kNone;
+    }
+
+    // First occupied slot index above after at one level, or kSlots
+    int nextOccupied(int level, int after) const
+    {
+        for (int index = after + 1; index < kSlots;)
+        {
+            std::uint64_t word = occupied[level][index / 64] >> (index % 64);
+            if (word)
+                return index + __builtin_ctzll(word);
+            index = (index / 64 + 1) * 64;
+        }
+        return kSlots;
+    }
+
+    // Earliest time after now at which some slot must be processed. A
+    // slot at level k is reached when the lower bytes of the clock roll
+    // over to zero, and always lies in the current rotation of level k + 1.
+    std::uint64_t nextEventTime() const
+    {
+        std::uint64_t best = std::numeric_limits<std::uint64_t>::max();
+        for (int level = 0; level < kLevels; ++level)
+        {
+            int shift = level * kSlotBits;
+            int index = nextOccupied(level, static_cast<int>((now >> shift) & (kSlots - 1)));
+            if (index == kSlots)
+                continue;
+            std::uint64_t rotation = (static_cast<std::uint64_t>(now) >> (shift + kSlotBits)) << (shift + kSlotBits);
+            best = std::min(best, rotation | (static_cast<std::uint64_t>(index) << shift));
+        }
+        return best;
+    }
+
+public:
+    explicit TimingWheel(int start = 0) : now(bias(start))
+    {
+        std::fill(std::begin(heads), std::end(heads), kNone);
+    }
+
+    TimingWheel(const TimingWheel &) = delete;
+    TimingWheel &operator=(const TimingWheel &) = delete;
+
+    int time() const
+    {
+        return static_cast<int>(now ^ 0x80000000u);
+    }
+
+    std::size_t size() const
+    {
+        return armed;
+    }
+
+    void reserve(std::size_t keys)
+    {
+        if (timers.size() < keys)
+            timers.resize(keys);
+    }
+
+    // Arm (or move) the timer for key to fire once the clock reaches when.
+    // Returns false, arming nothing, if when is not in the future.
+    bool schedule(std::uint32_t key, int when)
+    {
+        if (bias(when) <= now)
+            return false;
+        reserve(std::size_t(key) + 1);
+        cancel(key);
+        timers[key].when = bias(when);
+        link(key);
+        ++armed;
+        return true;
+    }
+
+    void cancel(std::uint32_t key)
+    {
+        if (key < timers.size() && timers[key].slot != kNone)
+        {
+            unlink(key);
+            --armed;
+        }
+    }
+
+    // Move the clock to time, calling fire(key) for every timer that
+    // expires on the way, in expiry order. fire may schedule or cancel
+    // other timers. Returns false, doing nothing, if time lies in the past.
+    template <typename Fn>
+    bool advance(int time, Fn &&fire)
+    {
+        std::uint32_t target = bias(time);
+        if (target < now)
+            return false;
+        while (armed > 0)
+        {
+            std::uint64_t next = nextEventTime();
+            if (next > target)
+                break;
+            now = static_cast<std::uint32_t>(next);
+            // Cascade from the top, so a timer can fall through several
+            // levels and still fire on this tick
+            for (int level = kLevels - 1; level > 0; --level)
+            {
+                int shift = level * kSlotBits;
+                if ((now & ((std::uint32_t(1) << shift) - 1)) != 0)
+                    continue;
+                std::uint32_t slot = static_cast<std::uint32_t>(level * kSlots) + ((now >> shift) & (kSlots - 1));
+                while (heads[slot] != kNone)
+                {
+                    std::uint32_t key = heads[slot];
+                    unlink(key);
+                    link(key);
+                }
+            }
+            std::uint32_t slot = now & (kSlots - 1);
+            while (heads[slot] != kNone)
+            {
+                std::uint32_t key = heads[slot];
+                unlink(key);
+                --armed;
+                fire(key);
+            }
+        }
+        now = target;
+        return true;
+    }
+
+    // Drop every timer and restart the clock at time
+    void reset(int time)
+    {
+        for (Timer &timer : timers)
+            timer.slot = kNone;
+        std::fill(std::begin(heads), std::end(heads), kNone);
+        std::memset(occupied, 0, sizeof(occupied));
+        armed = 0;
+        now = bias(time);
+    }
+
+    std::size_t memoryBytes() const
+    {
+        return timers.capacity() * sizeof(Timer) + sizeof(heads) + sizeof(occupied);
+    }
+};
+
+// On-disk snapshot layout, native byte order. The sections follow the
+// header at 8-byte aligned offsets: task records in topological order,
+// CSR dependency offsets (taskCount + 1 entries), dependency indices into
+// the task records, and the string pool holding names and descriptions.
+constexpr char kSnapshotMagic[8] = {'T', 'M', 'S', 'N', 'A', 'P', '\0', '\0'};
+constexpr std::uint32_t kSnapshotVersion = 3; // Version 2 added journalSequence, version 3 task durations
+
+struct SnapshotHeader
+{
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t headerSize;
+    std::uint64_t taskCount;
+    std::uint64_t edgeCount;
+    std::uint64_t stringBytes;
+    std::int64_t currentTime;
+    std::uint64_t tasksOffset;
+    std::uint64_t offsetsOffset;
+    std::uint64_t edgesOffset;
+    std::uint64_t stringsOffset;
+    std::uint64_t fileSize;
+    std::uint64_t checksum;        // FNV-1a over everything after the header
+    std::uint64_t journalSequence; // Last journal record folded into this snapshot (version 2)
+};
+
+struct SnapshotTask
+{
+    std::uint64_t nameOffset;
+    std::uint64_t descriptionOffset;
+    std::uint32_t nameLength;
+    std::uint32_t descriptionLength;
+    std::int32_t deadline;
+    float completion;
+    std::uint8_t status;
+    std::uint8_t completed;
+    std::uint8_t reserved[2];
+    std::int32_t duration; // Version 3; padding before
+};
+
+// 64-bit FNV-1a, continued from a previous value
+inline std::uint64_t fnv1a(const void *data, std::size_t size, std::uint64_t hash = 1469598103934665603ull)
+{
+    const unsigned char *bytes = static_cast<const unsigned char *>(data);
+    for (std::size_t i = 0; i < size; ++i)
+        hash = (hash ^ bytes[i]) * 1099511628211ull;
+    return hash;
+}
+
+// Read-only memory mapping of a whole file, unmapped on destruction
+class MappedFile
+{
+private:
+    const char *base = nullptr;
+    std::size_t length = 0;
+
+public:
+    MappedFile() = default;
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    ~MappedFile()
+    {
+        if (base)
+            munmap(const_cast<char *>(base), length);
+    }
+
+    bool open(const std::string &path)
+    {
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0)
+            return false;
+        struct stat info;
+        if (fstat(fd, &info) != 0 || info.st_size == 0)
+        {
+            ::close(fd);
+            return false;
+        }
+        void *mapped = mmap(nullptr, static_cast<std::size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (mapped == MAP_FAILED)
+            return false;
+        madvise(mapped, static_cast<std::size_t>(info.st_size), MADV_SEQUENTIAL);
+        base = static_cast<const char *>(mapped);
+        length = static_cast<std::size_t>(info.st_size);
+        return true;
+    }
+
+    const char *data() const
+    {
+        return base;
+    }
+
+    std::size_t size() const
+    {
+        return length;
+    }
+};
+
+// Mutation journal record types
+enum class JournalOp : std::uint8_t
+{
+    ADD_TASK = 1,
+    DELETE_TASK = 2,
+    ADD_DEPENDENCY = 3,
+    SET_STATUS = 4,
+    ADVANCE_CLOCK = 5,
+    SET_DURATION = 6
+};
+
+// A decoded journal record. Views point into the mapped journal file.
+struct JournalRecord
+{
+    JournalOp op;
+    std::uint64_t sequence;
+    std::string_view name;  // Task name
+    std::string_view other; // Description or dependency name
+    std::int32_t value;     // Deadline, status, clock ticks or duration
+    double completion;
+};
+
+// CRC-32 (IEEE) used to detect torn or corrupt journal records
+inline std::uint32_t crc32(const void *data, std::size_t size, std::uint32_t crc = 0)
+{
+    static const auto table = []
+    {
+        std::vector<std::uint32_t> t(256);
+        for (std::uint32_t i = 0; i < 256; ++i)
+        {
+            std::uint32_t c = i;
+            for (int k = 0; k < 8; ++k)
+                c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            t[i] = c;
+        }
+        return t;
+    }();
+    const unsigned char *bytes = static_cast<const unsigned char *>(data);
+    crc = ~crc;
+    for (std::size_t i = 0; i < size; ++i)
+        crc = table[(crc ^ bytes[i]) & 0xFF] ^ (crc >> 8);
+    return ~crc;
+}
+
+// Append-only write-ahead log of TaskManager mutations.
+//
+// Record layout: u32 length, u32 crc32, then `length` bytes holding the
+// u64 sequence number, the u8 op and the op's fields. Appending only
+// encodes into an in-memory batch. A flusher thread writes the batch with
+// a single fdatasync once it holds maxBatch records or its oldest record
+// is maxDelay old (group commit); sync() waits until everything appended
+// so far is durable.
+class Journal
+{
+private:
+    int fd = -1;
+    std::mutex lock;
+    std::condition_variable wake;
+    std::condition_variable durable;
+    std::thread flusher;
+    std::string pending; // Encoded records not yet written
+    std::size_t pendingRecords = 0;
+    std::uint64_t sequence = 0; // Last sequence number handed out
+    std::uint64_t committedSequence = 0;
+    std::uint64_t fileBytes = 0;
+    bool syncRequested = false;
+    bool stopping = false;
+    bool failed = false;
+    std::size_t maxBatch;
+    std::chrono::microseconds maxDelay;
+
+    static void putU32(std::string &out, std::uint32_t v)
+    {
+        out.append(reinterpret_cast<const char *>(&v), sizeof(v));
+    }
+
+    static void putString(std::string &out, std::string_view v)
+    {
+        putU32(out, static_cast<std::uint32_t>(v.size()));
+        out.append(v.data(), v.size());
+    }
+
+    void append(JournalOp op, std::string_view name, std::string_view other, std::int32_t value, double completion)
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        if (fd < 0)
+            return;
+        std::size_t start = pending.size();
+        putU32(pending, 0); // Length and crc are patched below
+        putU32(pending, 0);
+        ++sequence;
+        pending.append(reinterpret_cast<const char *>(&sequence), sizeof(sequence));
+        pending.push_back(static_cast<char>(op));
+        switch (op)
+        {
+        case JournalOp::ADD_TASK:
+            putString(pending, name);
+            putString(pending, other);
+            putU32(pending, static_cast<std::uint32_t>(value));
+            pending.append(reinterpret_cast<const char *>(&completion), sizeof(completion));
+            break;
+        case JournalOp::DELETE_TASK:
+            putString(pending, name);
+            break;
+        case JournalOp::ADD_DEPENDENCY:
+            putString(pending, name);
+            putString(pending, other);
+            break;
+        case JournalOp::SET_STATUS:
+        case JournalOp::SET_DURATION:
+            putString(pending, name);
+            putU32(pending, static_cast<std::uint32_t>(value));
+            break;
+        case JournalOp::ADVANCE_CLOCK:
+            putU32(pending, static_cast<std::uint32_t>(value));
+            break;
+        }
+        std::uint32_t length = static_cast<std::uint32_t>(pending.size() - start - 8);
+        std::uint32_t crc = crc32(pending.data() + start + 8, length);
+        std::memcpy(&pending[start], &length, sizeof(length));
+        std::memcpy(&pending[start + 4], &crc, sizeof(crc));
+        if (++pendingRecords >= maxBatch)
+            wake.notify_one();
+    }
+
+    void flushLoop()
+    {
+        std::unique_lock<std::mutex> guard(lock);
+        while (true)
+        {
+            wake.wait_for(guard, maxDelay, [this]
+                          { return stopping || syncRequested || pendingRecords >= maxBatch; });
+            if (pending.empty())
+            {
+                syncRequested = false;
+                if (stopping)
+                    return;
+                continue;
+            }
+
+            std::string batch;
+            batch.swap(pending);
+            std::uint64_t upTo = sequence;
+            pendingRecords = 0;
+            syncRequested = false;
+            guard.unlock();
+
+            bool ok = true;
+            for (std::size_t done = 0; ok && done < batch.size();)
+            {
+                ssize_t n = ::write(fd, batch.data() + done, batch.size() - done);
+                if (n < 0 && errno == EINTR)
+                    continue;
+                ok = n > 0;
+                if (ok)
+                    done += static_cast<std::size_t>(n);
+            }
+            ok = ok && fdatasync(fd) == 0;
+
+            guard.lock();
+            if (!ok && !failed)
+            {
+                failed = true;
+                std::cerr << "Error: journal write failed; later mutations are not durable." << std::endl;
+            }
+            committedSequence = upTo;
+            fileBytes += batch.size();
+            durable.notify_all();
+        }
+    }
+
+public:
+    explicit Journal(std::size_t maxBatch = 256, std::chrono::microseconds maxDelay = std::chrono::milliseconds(2))
+        : maxBatch(maxBatch), maxDelay(maxDelay)
+    {
+    }
+
+    Journal(const Journal &) = delete;
+    Journal &operator=(const Journal &) = delete;
+
+    ~Journal()
+    {
+        close();
+    }
+
+    // Open PATH for appending; new records are numbered after lastSequence
+    bool open(const std::string &path, std::uint64_t lastSequence)
+    {
+        close();
+        fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_APPEND, 0644);
+        if (fd < 0)
+            return false;
+        struct stat info;
+        fileBytes = fstat(fd, &info) == 0 ? static_cast<std::uint64_t>(info.st_size) : 0;
+        sequence = committedSequence = lastSequence;
+        stopping = failed = false;
+        flusher = std::thread(&Journal::flushLoop, this);
+        return true;
+    }
+
+    // Commit everything still pending and stop the flusher
+    void close()
+    {
+        if (fd < 0)
+            return;
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            stopping = true;
+        }
+        wake.notify_one();
+        flusher.join();
+        ::close(fd);
+        fd = -1;
+    }
+
+    // Block until every record appended so far is on disk
+    void sync()
+    {
+        std::unique_lock<std::mutex> guard(lock);
+        std::uint64_t target = sequence;
+        if (fd < 0 || committedSequence >= target)
+            return;
+        syncRequested = true;
+        wake.notify_one();
+        durable.wait(guard, [&]
+                     { return committedSequence >= target; });
+    }
+
+    // Drop every record once the state they describe is in a snapshot
+    bool truncate()
+    {
+        sync();
+        std::lock_guard<std::mutex> guard(lock);
+        if (fd < 0 || ftruncate(fd, 0) != 0 || fdatasync(fd) != 0)
+            return false;
+        fileBytes = 0;
+        return true;
+    }
+
+    std::uint64_t lastSequence()
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        return sequence;
+    }
+
+    // Bytes on disk plus bytes waiting for the next commit
+    std::uint64_t size()
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        return fileBytes + pending.size();
+    }
+
+    void logAddTask(std::string_view name, std::string_view description, int deadline, double completion)
+    {
+        append(JournalOp::ADD_TASK, name, description, deadline, completion);
+    }
+
+    void logDeleteTask(std::string_view name)
+    {
+        append(JournalOp::DELETE_TASK, name, {}, 0, 0.0);
+    }
+
+    void logDependency(std::string_view taskName, std::string_view dependencyName)
+    {
+        append(JournalOp::ADD_DEPENDENCY, taskName, dependencyName, 0, 0.0);
+    }
+
+    void logStatus(std::string_view name, CompletionStatus status)
+    {
+        append(JournalOp::SET_STATUS, name, {}, static_cast<std::int32_t>(status), 0.0);
+    }
+
+    void logClock(int ticks)
+    {
+        append(JournalOp::ADVANCE_CLOCK, {}, {}, ticks, 0.0);
+    }
+
+    void logDuration(std::string_view name, int duration)
+    {
+        append(JournalOp::SET_DURATION, name, {}, duration, 0.0);
+    }
+
+    // Decode every intact record of PATH in order. A torn or corrupt tail,
+    // left by a crash during a write, ends the replay and is cut off so new
+    // records follow the last good one. Returns the number of records
+    // passed to apply, or -1 if PATH exists but cannot be read.
+    static long replay(const std::string &path, const std::function<void(const JournalRecord &)> &apply)
+    {
+        struct stat info;
+        if (stat(path.c_str(), &info) != 0 || info.st_size == 0)
+            return 0;
+        MappedFile file;
+        if (!file.open(path))
+            return -1;
+
+        const char *data = file.data();
+        std::size_t size = file.size();
+        std::size_t offset = 0;
+        long applied = 0;
+        while (size - offset >= 8)
+        {
+            std::uint32_t length, crc;
+            std::memcpy(&length, data + offset, 4);
+            std::memcpy(&crc, data + offset + 4, 4);
+            if (length < 9 || length > size - offset - 8 || crc32(data + offset + 8, length) != crc)
+                break;
+
+            const char *cursor = data + offset + 8;
+            const char *end = cursor + length;
+            bool ok = true;
+            auto getU32 = [&](std::uint32_t &v)
+            {
+                ok = ok && end - cursor >= 4;
+                if (ok)
+                {
+                    std::memcpy(&v, cursor, 4);
+                    cursor += 4;
+                }
+            };
+            auto getString = [&](std::string_view &v)
+            {
+                std::uint32_t n = 0;
+                getU32(n);
+                ok = ok && static_cast<std::size_t>(end - cursor) >= n;
+                if (ok)
+                {
+                    v = std::string_view(cursor, n);
+                    cursor += n;
+                }
+            };
+
+            JournalRecord record = {};
+            std::memcpy(&record.sequence, cursor, 8);
+            record.op = static_cast<JournalOp>(cursor[8]);
+            cursor += 9;
+            std::uint32_t value = 0;
+            switch (record.op)
+            {
+            case JournalOp::ADD_TASK:
+                getString(record.name);
+                getString(record.other);
+                getU32(value);
+                ok = ok && end - cursor >= 8;
+                if (ok)
+                    std::memcpy(&record.completion, cursor, 8);
+                break;
+            case JournalOp::DELETE_TASK:
+                getString(record.name);
+                break;
+            case JournalOp::ADD_DEPENDENCY:
+                getString(record.name);
+                getString(record.other);
+                break;
+            case JournalOp::SET_STATUS:
+            case JournalOp::SET_DURATION:
+                getString(record.name);
+                getU32(value);
+                break;
+            case JournalOp::ADVANCE_CLOCK:
+                getU32(value);
+                break;
+            default:
+                ok = false;
+            }
+            if (!ok)
+                break;
+            record.value = static_cast<std::int32_t>(value);
+            apply(record);
+            ++applied;
+            offset += 8 + length;
+        }
+
+        if (offset < size)
+        {
+            int fd = ::open(path.c_str(), O_WRONLY);
+            if (fd >= 0)
+            {
+                if (ftruncate(fd, static_cast<off_t>(offset)) == 0)
+                    fdatasync(fd);
+                ::close(fd);
+            }
+        }
+        return applied;
+    }
+};
+
+// Bulk adds fall back to per-item incremental updates (heap sifts,
+// incremental topological order) when the existing tasks outnumber the
+// batch by this factor, rather than rebuilding whole structures
+constexpr std::size_t kIncrementalBatchRatio = 16;
+
+// Log levels. Messages below TM_LOG_LEVEL are compiled out entirely; the
+// rest are filtered at runtime against logLevel().
+enum class LogLevel
+{
+    TRACE,
+    DEBUG,
+    INFO,
+    WARN,
+    ERROR,
+    OFF
+};
+
+#ifndef TM_LOG_LEVEL
+#define TM_LOG_LEVEL 2 // LogLevel::INFO
+#endif
+
+inline std::atomic<int> &logLevel()
+{
+    static std::atomic<int> level(TM_LOG_LEVEL);
+    return level;
+}
+
+inline bool logEnabled(LogLevel level)
+{
+    return static_cast<int>(level) >= logLevel().load(std::memory_order_relaxed);
+}
+
+// TM_LOG(WARN, "Task '" << name << "' not found.") writes one line to stdout
+#define TM_LOG(level, message)                                                     \
+    do                                                                             \
+    {                                                                              \
+        if constexpr (static_cast<int>(LogLevel::level) >= TM_LOG_LEVEL)           \
+        {                                                                          \
+            if (logEnabled(LogLevel::level))                                       \
+                std::cout << message << '\n';                                      \
+        }                                                                          \
+    } while (0)
+
+// Operations with their own counter and latency histogram
+enum class StatOp
+{
+    ADD_TASK,
+    DELETE_TASK,
+    ADD_DEPENDENCY,
+    SET_STATUS,
+    DISPATCH,
+    LOOKUP,
+    BULK_ADD,
+    BULK_DEPENDENCIES,
+    RESCORE,
+    ANALYZE,
+    SNAPSHOT,
+    BATCH,
+    COUNT
+};
+
+inline const char *statOpName(StatOp op)
+{
+    static const char *const names[] = {"addTask", "deleteTask", "addDependency", "setStatus", "dispatch", "lookup",
+                                        "addTasksBulk", "addDependenciesBulk", "rescore", "analyzeSchedule", "snapshot",
+                                        "applyBatch"};
+    return names[static_cast<int>(op)];
+}
+
+// Log-linear latency histogram in the style of HdrHistogram: values below
+// 16 ns get a bucket each, every larger power of two is split into 16
+// buckets, so any recorded value is known to within about 6%. Recording
+// is one relaxed atomic increment, so readers on other threads never block
+// the thread being measured.
+class LatencyHistogram
+{
+private:
+    static constexpr int kSubBits = 4;
+    static constexpr int kSubBuckets = 1 << kSubBits;
+    static constexpr int kBuckets = (64 - kSubBits + 1) * kSubBuckets;
+
+    std::atomic<std::uint64_t> counts[kBuckets] = {};
+    std::atomic<std::uint64_t> total{0};
+    std::atomic<std::uint64_t> sumNs{0};
+    std::atomic<std::uint64_t> maxNs{0};
+
+    static int bucketOf(std::uint64_t ns)
+    {
+        if (ns < kSubBuckets)
+            return static_cast<int>(ns);
+        int exponent = 63 - __builtin_clzll(ns);
+        int sub = static_cast<int>((ns >> (exponent - kSubBits)) & (kSubBuckets - 1));
+        return (exponent - kSubBits + 1) * kSubBuckets + sub;
+    }
+
+    // Upper edge of a bucket, reported for percentiles
+    static std::uint64_t bucketLimit(int bucket)
+    {
+        if (bucket < kSubBuckets)
+            return static_cast<std::uint64_t>(bucket);
+        int exponent = bucket / kSubBuckets + kSubBits - 1;
+        std::uint64_t sub = static_cast<std::uint64_t>(bucket % kSubBuckets);
+        return ((kSubBuckets + sub + 1) << (exponent - kSubBits)) - 1;
+    }
+
+public:
+    void record(std::uint64_t ns)
+    {
+        counts[bucketOf(ns)].fetch_add(1, std::memory_order_relaxed);
+        total.fetch_add(1, std::memory_order_relaxed);
+        sumNs.fetch_add(ns, std::memory_order_relaxed);
+        std::uint64_t seen = maxNs.load(std::memory_order_relaxed);
+        while (ns > seen && !maxNs.compare_exchange_weak(seen, ns, std::memory_order_relaxed))
+        {
+        }
+    }
+
+    std::uint64_t count() const
+    {
+        return total.load(std::memory_order_relaxed);
+    }
+
+    double meanNs() const
+    {
+        std::uint64_t n = count();
+        return n ? static_cast<double>(sumNs.load(std::memory_order_relaxed)) / n : 0.0;
+    }
+
+    std::uint64_t max() const
+    {
+        return maxNs.load(std::memory_order_relaxed);
+    }
+
+    // Smallest bucket limit covering fraction q of the recorded values
+    std::uint64_t percentile(double q) const
+    {
+        std::uint64_t n = count();
+        if (n == 0)
+            return 0;
+        std::uint64_t rank = static_cast<std::uint64_t>(std::ceil(q * n));
+        std::uint64_t seen = 0;
+        for (int b = 0; b < kBuckets; ++b)
+        {
+            seen += counts[b].load(std::memory_order_relaxed);
+            if (seen >= std::max<std::uint64_t>(rank, 1))
+                return std::min(bucketLimit(b), max());
+        }
+        return max();
+    }
+};
+
+// One histogram per StatOp
+struct TaskManagerStats
+{
+    LatencyHistogram ops[static_cast<int>(StatOp::COUNT)];
+
+    LatencyHistogram &operator[](StatOp op)
+    {
+        return ops[static_cast<int>(op)];
+    }
+
+    const LatencyHistogram &operator[](StatOp op) const
+    {
+        return ops[static_cast<int>(op)];
+    }
+};
+
+// Times the enclosing scope into one histogram. Defining TM_NO_STATS turns
+// it into an empty object, removing the clock reads as well.
+class OpTimer
+{
+#ifndef TM_NO_STATS
+private:
+    LatencyHistogram &histogram;
+    std::chrono::steady_clock::time_point start;
+
+public:
+    OpTimer(TaskManagerStats &stats, StatOp op) : histogram(stats[op]), start(std::chrono::steady_clock::now()) {}
+
+    ~OpTimer()
+    {
+        auto elapsed = std::chrono::steady_clock::now() - start;
+        histogram.record(static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()));
+    }
+#else
+public:
+    OpTimer(TaskManagerStats &, StatOp) {}
+#endif
+    OpTimer(const OpTimer &) = delete;
+    OpTimer &operator=(const OpTimer &) = delete;
+};
+
+// Resident set size of this process in bytes, 0 if unknown
+inline std::size_t residentBytes()
+{
+    std::FILE *statm = std::fopen("/proc/self/statm", "r");
+    if (!statm)
+        return 0;
+    unsigned long pages = 0, resident = 0;
+    int fields = std::fscanf(statm, "%lu %lu", &pages, &resident);
+    std::fclose(statm);
+    return fields == 2 ? resident * static_cast<std::size_t>(sysconf(_SC_PAGESIZE)) : 0;
+}
+
+// Number of tasks shown per page of the task view
+constexpr std::size_t kTaskPageSize = 50;
+
+// Accumulates console output in memory and hands it to stdout in a single
+// write, instead of flushing after every line
+class OutputBuffer
+{
+private:
+    std::string text;
+
+public:
+    OutputBuffer &operator<<(std::string_view value)
+    {
+        text.append(value);
+        return *this;
+    }
+
+    OutputBuffer &operator<<(char value)
+    {
+        text.push_back(value);
+        return *this;
+    }
+
+    OutputBuffer &operator<<(long long value)
+    {
+        char digits[24];
+        auto result = std::to_chars(digits, digits + sizeof(digits), value);
+        text.append(digits, result.ptr);
+        return *this;
+    }
+
+    OutputBuffer &operator<<(int value)
+    {
+        return *this << static_cast<long long>(value);
+    }
+
+    OutputBuffer &operator<<(std::size_t value)
+    {
+        return *this << static_cast<long long>(value);
+    }
+
+    // Same six significant digits std::cout prints by default
+    OutputBuffer &operator<<(double value)
+    {
+        char digits[32];
+        int length = std::snprintf(digits, sizeof(digits), "%g", value);
+        text.append(digits, static_cast<std::size_t>(length));
+        return *this;
+    }
+
+    void reserve(std::size_t bytes)
+    {
+        text.reserve(bytes);
+    }
+
+    void flush()
+    {
+        std::cout.write(text.data(), static_cast<std::streamsize>(text.size()));
+        std::cout.flush();
+        text.clear();
+    }
+};
+
+// Result of the schedule analysis for one task, in clock units
+struct ScheduleInfo
+{
+    std::int64_t earliestStart = 0;
+    std::int64_t earliestFinish = 0;
+    std::int64_t latestStart = 0;
+    std::int64_t latestFinish = 0;
+    std::int64_t slack = 0; // Negative: the task cannot meet its own or a downstream deadline
+};
+
+// Levels of the schedule analysis smaller than this are processed on the
+// calling thread; spawning workers costs more than the work
+constexpr std::size_t kParallelLevelMin = 1 << 14;
+
+// Plain task fields used for bulk loading
+struct TaskRecord
+{
+    std::string name;
+    std::string description;
+    int deadline = 0;
+    double completion = 0.0;
+    int duration = kDefaultDuration;
+};
+
+enum class BatchOpKind
+{
+    ADD_TASK,
+    DELETE_TASK,
+    ADD_DEPENDENCY,
+    SET_STATUS
+};
+
+// One change inside a TaskBatch
+struct BatchOp
+{
+    BatchOpKind kind;
+    TaskRecord task;        // ADD_TASK uses every field, the others only the name
+    std::string dependency; // ADD_DEPENDENCY
+    CompletionStatus status = CompletionStatus::NOT_STARTED;
+};
+
+// Changes applied all-or-nothing by applyBatch. They take effect in the
+// order they were added, so a batch may delete a task and add a new one
+// under the same name.
+class TaskBatch
+{
+private:
+    std::vector<BatchOp> ops;
+
+public:
+    void addTask(std::string name, std::string description, int deadline, double completion, int duration = kDefaultDuration)
+    {
+        ops.push_back(BatchOp{BatchOpKind::ADD_TASK, TaskRecord{std::move(name), std::move(description), deadline, completion, duration}, {}, {}});
+    }
+
+    void deleteTask(std::string name)
+    {
+        ops.push_back(BatchOp{BatchOpKind::DELETE_TASK, TaskRecord{std::move(name), {}, 0, 0.0, kDefaultDuration}, {}, {}});
+    }
+
+    void addDependency(std::string taskName, std::string dependencyName)
+    {
+        ops.push_back(BatchOp{BatchOpKind::ADD_DEPENDENCY, TaskRecord{std::move(taskName), {}, 0, 0.0, kDefaultDuration}, std::move(dependencyName), {}});
+    }
+
+    void setStatus(std::string name, CompletionStatus status)
+    {
+        ops.push_back(BatchOp{BatchOpKind::SET_STATUS, TaskRecord{std::move(name), {}, 0, 0.0, kDefaultDuration}, {}, status});
+    }
+
+    const std::vector<BatchOp> &operations() const
+    {
+        return ops;
+    }
+
+    std::size_t size() const
+    {
+        return ops.size();
+    }
+
+    bool empty() const
+    {
+        return ops.empty();
+    }
+
+    void clear()
+    {
+        ops.clear();
+    }
+};
+
+// Persistent 32-way trie from 32-bit keys to immutable values. An update
+// copies the nodes on its path and shares the rest, so copying the trie
+// is O(1) and a copy never changes. Nodes created under the current edit
+// number are not shared yet and are updated in place; bumping the edit
+// number seals everything created so far.
+template <typename T>
+class PersistentTrie
+{
+private:
+    static constexpr unsigned kBits = 5;
+    static constexpr unsigned kWidth = 1u << kBits;
+    static constexpr unsigned kLevels = 7; // 7 * 5 bits cover every 32-bit key
+
+    struct Node
+    {
+        std::uint64_t edit = 0;
+        std::shared_ptr<const void> slots[kWidth]; // Child nodes, or values on the last level
+    };
+
+    std::shared_ptr<const Node> root;
+    std::size_t count = 0;
+
+    static unsigned slotOf(std::uint32_t key, unsigned level)
+    {
+        return (key >> (kBits * (kLevels - 1 - level))) & (kWidth - 1);
+    }
+
+    // Copy node unless the current edit created it; only then is writing through the const pointer safe
+    static Node *editable(std::shared_ptr<const void> &slot, std::uint64_t edit)
+    {
+        auto node = std::static_pointer_cast<const Node>(slot);
+        if (!node || node->edit != edit)
+        {
+            auto copy = node ? std::make_shared<Node>(*node) : std::make_shared<Node>();
+            copy->edit = edit;
+            slot = copy;
+            return copy.get();
+        }
+        return const_cast<Node *>(node.get());
+    }
+
+    template <typename Fn>
+    static void visit(const Node *node, unsigned level, std::uint32_t prefix, Fn &fn)
+    {
+        for (unsigned i = 0; i < kWidth; ++i)
+        {
+            const void *slot = node->slots[i].get();
+            if (!slot)
+                continue;
+            std::uint32_t key = (prefix << kBits) | i;
+            if (level + 1 == kLevels)
+                fn(key, *static_cast<const T *>(slot));
+            else
+                visit(static_cast<const Node *>(slot), level + 1, key, fn);
+        }
+    }
+
+public:
+    const T *find(std::uint32_t key) const
+    {
+        const Node *node = root.get();
+        for (unsigned level = 0; node && level + 1 < kLevels; ++level)
+            node = static_cast<const Node *>(node->slots[slotOf(key, level)].get());
+        return node ? static_cast<const T *>(node->slots[slotOf(key, kLevels - 1)].get()) : nullptr;
+    }
+
+    // Store value under key; nullptr erases it
+    void assign(std::uint32_t key, std::shared_ptr<const T> value, std::uint64_t edit)
+    {
+        if (!root && !value)
+            return;
+        std::shared_ptr<const void> top = root;
+        Node *node = editable(top, edit);
+        root = std::static_pointer_cast<const Node>(top);
+        for (unsigned level = 0; level + 1 < kLevels; ++level)
+            node = editable(node->slots[slotOf(key, level)], edit);
+
+        std::shared_ptr<const void> &slot = node->slots[slotOf(key, kLevels - 1)];
+        count += (value ? 1 : 0) - (slot ? 1 : 0);
+        slot = std::move(value);
+    }
+
+    std::size_t size() const
+    {
+        return count;
+    }
+
+    // Call fn(key, value) for every entry in key order
+    template <typename Fn>
+    void forEach(Fn fn) const
+    {
+        if (root)
+            visit(root.get(), 0, 0, fn);
+    }
+};
+
+// A task's fields as of one published version
+struct TaskView
+{
+    TaskId id = kInvalidTaskId;
+    std::uint32_t generation = 0;
+    std::string name;
+    std::string description;
+    int deadline = 0;
+    double completion = 0.0;
+    int duration = kDefaultDuration;
+    CompletionStatus status = CompletionStatus::NOT_STARTED;
+    float priority = 0.0f;
+    bool completed = false; // Executed by the scheduler
+    bool approaching = false;
+    bool overdue = false;
+    std::vector<TaskId> dependencies;
+};
+
+// Name hash used as the key of the version name index. Keys are kept
+// dense (2^20 buckets) so the trie stays shallow and compact; the few
+// names that share a bucket are told apart by comparing them.
+inline std::uint32_t nameKey(std::string_view name)
+{
+    return static_cast<std::uint32_t>(std::hash<std::string_view>()(name)) & ((1u << 20) - 1);
+}
+
+// Immutable state of a task manager as of one publishVersion call. Any
+// thread may read it while the manager keeps changing; it shares all
+// unchanged tasks with the versions before and after it.
+class TaskVersion
+{
+private:
+    PersistentTrie<TaskView> tasks;
+    PersistentTrie<std::vector<TaskId>> names; // nameKey -> ids of the tasks with that key
+    std::uint64_t number;
+    int clock;
+
+public:
+    TaskVersion(PersistentTrie<TaskView> tasks, PersistentTrie<std::vector<TaskId>> names, std::uint64_t number, int clock)
+        : tasks(std::move(tasks)), names(std::move(names)), number(number), clock(clock) {}
+
+    const TaskView *at(TaskId id) const
+    {
+        return tasks.find(id);
+    }
+
+    const TaskView *find(std::string_view name) const
+    {
+        const std::vector<TaskId> *ids = names.find(nameKey(name));
+        if (!ids)
+            return nullptr;
+        for (TaskId id : *ids)
+        {
+            const TaskView *view = tasks.find(id);
+            if (view->name == name)
+                return view;
+        }
+        return nullptr;
+    }
+
+    // Call fn(const TaskView &) for every task in id order
+    template <typename Fn>
+    void forEach(Fn fn) const
+    {
+        tasks.forEach([&](std::uint32_t, const TaskView &view)
+                      { fn(view); });
+    }
+
+    std::size_t size() const
+    {
+        return tasks.size();
+    }
+
+    // Increases by one with every publishVersion call
+    std::uint64_t version() const
+    {
+        return number;
+    }
+
+    int time() const
+    {
+        return clock;
+    }
+};
+
+#ifdef TM_HAS_COROUTINES
+class CoroutineExecutor;
+
+// One-shot event that coroutines wait on without holding a thread. The
+// state is this once the event is set, otherwise the head of a lock-free
+// list of waiters; set() hands every queued waiter to its notify function.
+class AsyncEvent
+{
+public:
+    struct Waiter
+    {
+        Waiter *next = nullptr;
+        void (*notify)(Waiter *) = nullptr;
+    };
+
+private:
+    std::atomic<void *> state{nullptr};
+
+public:
+    bool isSet() const
+    {
+        return state.load(std::memory_order_acquire) == this;
+    }
+
+    // Queue a waiter; false if the event is already set and it was not queued
+    bool subscribe(Waiter *waiter)
+    {
+        void *head = state.load(std::memory_order_acquire);
+        do
+        {
+            if (head == this)
+                return false;
+            waiter->next = static_cast<Waiter *>(head);
+        } while (!state.compare_exchange_weak(head, waiter, std::memory_order_acq_rel, std::memory_order_acquire));
+        return true;
+    }
+
+    void set()
+    {
+        void *head = state.exchange(this, std::memory_order_acq_rel);
+        if (head == this)
+            return;
+        for (Waiter *waiter = static_cast<Waiter *>(head); waiter;)
+        {
+            Waiter *next = waiter->next; // notify may resume the owner and free the waiter
+            waiter->notify(waiter);
+            waiter = next;
+        }
+    }
+};
+
+// Return type of a coroutine task body. The frame starts suspended; the
+// executor resumes it on a pool thread and, when the body returns, marks
+// the task finished and frees the frame.
+class AsyncTask
+{
+public:
+    struct promise_type
+    {
+        CoroutineExecutor *executor = nullptr;
+        TaskId id = kInvalidTaskId;
+        std::exception_ptr error; // Set if the body threw
+
+        struct FinalAwaiter
+        {
+            bool await_ready() noexcept
+            {
+                return false;
+            }
+            void await_suspend(std::coroutine_handle<promise_type> handle) noexcept;
+            void await_resume() noexcept {}
+        };
+
+        AsyncTask get_return_object()
+        {
+            return AsyncTask(std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+        std::suspend_always initial_suspend() noexcept
+        {
+            return {};
+        }
+        FinalAwaiter final_suspend() noexcept
+        {
+            return {};
+        }
+        void return_void() {}
+        void unhandled_exception()
+        {
+            error = std::current_exception();
+        }
+    };
+
+    explicit AsyncTask(std::coroutine_handle<promise_type> frame) : handle(frame) {}
+    AsyncTask(AsyncTask &&other) noexcept : handle(std::exchange(other.handle, {})) {}
+    AsyncTask(const AsyncTask &) = delete;
+    AsyncTask &operator=(const AsyncTask &) = delete;
+
+    ~AsyncTask()
+    {
+        if (handle)
+            handle.destroy();
+    }
+
+    // Hand the frame over to an executor
+    std::coroutine_handle<promise_type> release()
+    {
+        return std::exchange(handle, {});
+    }
+
+private:
+    std::coroutine_handle<promise_type> handle;
+};
+
+// Runs coroutine task bodies on a small thread pool. A suspended body
+// holds no thread: while it waits on dependencies it sits in their
+// events' waiter lists, while it sleeps in the timer heap and while it
+// waits for I/O in the epoll set of the reactor thread, which also fires
+// the timers. Each in-flight task costs its coroutine frame and one event.
+class CoroutineExecutor
+{
+private:
+    using Clock = std::chrono::steady_clock;
+    using Timer = std::pair<Clock::time_point, std::coroutine_handle<>>;
+
+    struct TimerLater
+    {
+        bool operator()(const Timer &a, const Timer &b) const
+        {
+            return a.first > b.first;
+        }
+    };
+
+    std::unique_ptr<AsyncEvent[]> finished;   // Finish event per TaskId
+    std::vector<TaskId> finishOrder;          // Ids in the order their bodies returned
+    std::atomic<std::size_t> finishCount{0};
+    std::mutex failureLock;
+    std::vector<std::pair<TaskId, std::exception_ptr>> failures; // Bodies that threw
+    std::atomic<std::size_t> outstanding{0};  // Bodies spawned but not yet returned
+    std::mutex queueLock;
+    std::condition_variable queueReady;
+    std::deque<std::coroutine_handle<>> runQueue; // Coroutines ready to resume
+    std::mutex timerLock;
+    std::vector<Timer> timers;                // Min-heap of sleeping coroutines
+    std::mutex doneLock;
+    std::condition_variable allDone;
+    std::atomic<bool> stopping{false};
+    int epollFd = -1;
+    int wakeFd = -1;                          // eventfd that interrupts the reactor's wait
+
+    void workerLoop()
+    {
+        while (true)
+        {
+            std::coroutine_handle<> handle;
+            {
+                std::unique_lock<std::mutex> lock(queueLock);
+                queueReady.wait(lock, [this]
+                                { return !runQueue.empty() || stopping.load(std::memory_order_acquire); });
+                if (runQueue.empty())
+                    return;
+                handle = runQueue.front();
+                runQueue.pop_front();
+            }
+            handle.resume();
+        }
+    }
+
+    void reactorLoop()
+    {
+        epoll_event events[64];
+        while (!stopping.load(std::memory_order_acquire))
+        {
+            int timeout = -1;
+            {
+                std::lock_guard<std::mutex> lock(timerLock);
+                if (!timers.empty())
+                {
+                    auto wait = std::chrono::ceil<std::chrono::milliseconds>(timers.front().first - Clock::now());
+                    timeout = static_cast<int>(std::clamp<std::int64_t>(wait.count(), 0, std::numeric_limits<int>::max()));
+                }
+            }
+
+            int ready = epoll_wait(epollFd, events, 64, timeout);
+            for (int i = 0; i < ready; ++i)
+            {
+                if (!events[i].data.ptr)
+                {
+                    std::uint64_t count;
+                    ssize_t ignored = ::read(wakeFd, &count, sizeof(count));
+                    (void)ignored;
+                    continue;
+                }
+                // The awaiter lives in the coroutine frame: unregister before resuming it
+                auto *waiter = static_cast<IoWait *>(events[i].data.ptr);
+                std::coroutine_handle<> handle = waiter->handle;
+                epoll_ctl(epollFd, EPOLL_CTL_DEL, waiter->fd, nullptr);
+                schedule(handle);
+            }
+
+            std::lock_guard<std::mutex> lock(timerLock);
+            Clock::time_point now = Clock::now();
+            while (!timers.empty() && timers.front().first <= now)
+            {
+                std::pop_heap(timers.begin(), timers.end(), TimerLater());
+                schedule(timers.back().second);
+                timers.pop_back();
+            }
+        }
+    }
+
+    void wakeReactor()
+    {
+        std::uint64_t one = 1;
+        ssize_t ignored = ::write(wakeFd, &one, sizeof(one));
+        (void)ignored;
+    }
+
+public:
+    // Registration of a coroutine waiting for a file descriptor. co_await
+    // yields 0 once the descriptor is ready, or the errno that kept it from
+    // being watched: EEXIST if another coroutine is already waiting on the
+    // same descriptor, EBADF for a closed one.
+    struct IoWait
+    {
+        CoroutineExecutor *executor;
+        int fd;
+        std::uint32_t events;
+        std::coroutine_handle<> handle;
+        int error = 0;
+
+        bool await_ready() const
+        {
+            return false;
+        }
+
+        // Descriptors epoll cannot watch (EPERM), such as regular files, are
+        // always ready
+        bool await_suspend(std::coroutine_handle<> awaiting)
+        {
+            handle = awaiting;
+            epoll_event event{};
+            event.events = events | EPOLLONESHOT;
+            event.data.ptr = this;
+            if (epoll_ctl(executor->epollFd, EPOLL_CTL_ADD, fd, &event) == 0)
+                return true;
+            error = errno == EPERM ? 0 : errno;
+            return false;
+        }
+
+        int await_resume() const
+        {
+            return error;
+        }
+    };
+
+    // Sleep of a coroutine on the reactor's timer heap
+    struct SleepWait
+    {
+        CoroutineExecutor *executor;
+        Clock::time_point wakeAt;
+
+        bool await_ready() const
+        {
+            return wakeAt <= Clock::now();
+        }
+
+        // Once queued the coroutine may resume and free this awaiter at any time
+        void await_suspend(std::coroutine_handle<> awaiting)
+        {
+            CoroutineExecutor *owner = executor;
+            bool earliest;
+            {
+                std::lock_guard<std::mutex> lock(owner->timerLock);
+                earliest = owner->timers.empty() || wakeAt < owner->timers.front().first;
+                owner->timers.emplace_back(wakeAt, awaiting);
+                std::push_heap(owner->timers.begin(), owner->timers.end(), TimerLater());
+            }
+            if (earliest)
+                owner->wakeReactor();
+        }
+
+        void await_resume() const {}
+    };
+
+    // Wait for every dependency of a node. Each unfinished dependency gets
+    // a link in its event's waiter list; the last one to fire resumes the
+    // coroutine. remaining holds one extra reference until all links are
+    // queued, so a dependency finishing meanwhile cannot resume it early.
+    struct DependencyWait
+    {
+        struct Link : AsyncEvent::Waiter
+        {
+            DependencyWait *owner = nullptr;
+        };
+
+        CoroutineExecutor *executor;
+        const GraphNode *node;
+        std::vector<Link> links;
+        std::atomic<std::size_t> remaining{0};
+        std::coroutine_handle<> handle;
+
+        DependencyWait(CoroutineExecutor *owner, const GraphNode *waiting) : executor(owner), node(waiting) {}
+
+        static void release(AsyncEvent::Waiter *waiter)
+        {
+            DependencyWait *wait = static_cast<Link *>(waiter)->owner;
+            if (wait->remaining.fetch_sub(1, std::memory_order_acq_rel) == 1)
+                wait->executor->schedule(wait->handle);
+        }
+
+        bool await_ready() const
+        {
+            for (const GraphNode *dep : node->dependencies)
+            {
+                if (!executor->finished[dep->id].isSet())
+                    return false;
+            }
+            return true;
+        }
+
+        bool await_suspend(std::coroutine_handle<> awaiting)
+        {
+            handle = awaiting;
+            links.resize(node->dependencies.size());
+            remaining.store(links.size() + 1, std::memory_order_relaxed);
+            std::size_t dropped = 1;
+            for (std::size_t i = 0; i < links.size(); ++i)
+            {
+                links[i].owner = this;
+                links[i].notify = &DependencyWait::release;
+                if (!executor->finished[node->dependencies[i]->id].subscribe(&links[i]))
+                    ++dropped;
+            }
+            // Suspend unless every dependency finished while subscribing
+            return remaining.fetch_sub(dropped, std::memory_order_acq_rel) != dropped;
+        }
+
+        void await_resume() const {}
+    };
+
+    CoroutineExecutor(std::size_t taskSlots, std::size_t taskCount)
+        : finished(new AsyncEvent[taskSlots]), finishOrder(taskCount)
+    {
+        epollFd = epoll_create1(EPOLL_CLOEXEC);
+        wakeFd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+        if (epollFd < 0 || wakeFd < 0)
+            throw std::runtime_error(std::string("Cannot create coroutine reactor: ") + std::strerror(errno));
+        epoll_event event{};
+        event.events = EPOLLIN;
+        event.data.ptr = nullptr;
+        epoll_ctl(epollFd, EPOLL_CTL_ADD, wakeFd, &event);
+    }
+
+    CoroutineExecutor(const CoroutineExecutor &) = delete;
+    CoroutineExecutor &operator=(const CoroutineExecutor &) = delete;
+
+    ~CoroutineExecutor()
+    {
+        ::close(wakeFd);
+        ::close(epollFd);
+    }
+
+    // Mark a task that finished before this run, releasing its waiters
+    void markFinished(TaskId id)
+    {
+        finished[id].set();
+    }
+
+    // Queue a body to start once run() is called
+    void spawn(AsyncTask body, TaskId id)
+    {
+        std::coroutine_handle<AsyncTask::promise_type> handle = body.release();
+        handle.promise().executor = this;
+        handle.promise().id = id;
+        outstanding.fetch_add(1, std::memory_order_relaxed);
+        schedule(handle);
+    }
+
+    // Queue a suspended coroutine for a pool thread
+    void schedule(std::coroutine_handle<> handle)
+    {
+        {
+            std::lock_guard<std::mutex> lock(queueLock);
+            runQueue.push_back(handle);
+        }
+        queueReady.notify_one();
+    }
+
+    // Called as a body returns: release its waiters and record the order
+    void finish(TaskId id, std::exception_ptr error)
+    {
+        if (error)
+        {
+            std::lock_guard<std::mutex> lock(failureLock);
+            failures.emplace_back(id, std::move(error));
+        }
+        finished[id].set();
+        finishOrder[finishCount.fetch_add(1, std::memory_order_acq_rel)] = id;
+        if (outstanding.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        {
+            std::lock_guard<std::mutex> lock(doneLock);
+            allDone.notify_all();
+        }
+    }
+
+    // Run every spawned body to completion on workerCount threads. A body
+    // that never gets what it awaits keeps this from returning.
+    void run(unsigned workerCount)
+    {
+        std::thread reactor(&CoroutineExecutor::reactorLoop, this);
+        std::vector<std::thread> workers;
+        for (unsigned w = 0; w < std::max(1u, workerCount); ++w)
+            workers.emplace_back(&CoroutineExecutor::workerLoop, this);
+
+        {
+            std::unique_lock<std::mutex> lock(doneLock);
+            allDone.wait(lock, [this]
+                         { return outstanding.load(std::memory_order_acquire) == 0; });
+        }
+
+        stopping.store(true, std::memory_order_release);
+        {
+            std::lock_guard<std::mutex> lock(queueLock); // No worker may miss the stop between its check and its wait
+        }
+        queueReady.notify_all();
+        wakeReactor();
+        for (auto &worker : workers)
+            worker.join();
+        reactor.join();
+    }
+
+    std::size_t finishedCount() const
+    {
+        return finishCount.load(std::memory_order_acquire);
+    }
+
+    TaskId finishedAt(std::size_t index) const
+    {
+        return finishOrder[index];
+    }
+
+    // Bodies that threw, with their exceptions; read after run()
+    const std::vector<std::pair<TaskId, std::exception_ptr>> &failedTasks() const
+    {
+        return failures;
+    }
+};
+
+// Frees the frame before reporting, since the report may end the run
+inline void AsyncTask::promise_type::FinalAwaiter::await_suspend(std::coroutine_handle<promise_type> handle) noexcept
+{
+    CoroutineExecutor *executor = handle.promise().executor;
+    TaskId id = handle.promise().id;
+    std::exception_ptr error = std::move(handle.promise().error);
+    handle.destroy();
+    executor->finish(id, std::move(error));
+}
+
+// What a coroutine task body gets to work with: its task and awaitables
+// for dependencies, timers and file descriptors
+class TaskContext
+{
+private:
+    CoroutineExecutor *executor;
+    Task *task;
+    const GraphNode *node;
+
+public:
+    TaskContext(CoroutineExecutor *owner, Task *running, const GraphNode *graphNode) : executor(owner), task(running), node(graphNode) {}
+
+    Task &getTask() const
+    {
+        return *task;
+    }
+
+    // Resumes once every dependency of the task has finished
+    CoroutineExecutor::DependencyWait dependencies() const
+    {
+        return CoroutineExecutor::DependencyWait(executor, node);
+    }
+
+    CoroutineExecutor::SleepWait sleepFor(std::chrono::steady_clock::duration delay) const
+    {
+        return CoroutineExecutor::SleepWait{executor, std::chrono::steady_clock::now() + delay};
+    }
+
+    CoroutineExecutor::IoWait readable(int fd) const
+    {
+        return CoroutineExecutor::IoWait{executor, fd, EPOLLIN, {}, 0};
+    }
+
+    CoroutineExecutor::IoWait writable(int fd) const
+    {
+        return CoroutineExecutor::IoWait{executor, fd, EPOLLOUT, {}, 0};
+    }
+};
+
+// Executable body of a task
+using TaskBody = std::function<AsyncTask(TaskContext)>;
+
+// Outcome of BasicTaskManager::executeTasksAsync
+struct AsyncRunStats
+{
+    std::size_t executed = 0;
+    std::size_t failed = 0; // Bodies that threw; their tasks still count as finished
+    unsigned workers = 0;
+    double makespanMs = 0.0;
+};
+#endif
+
+enum class GraphDirection
+{
+    DEPENDENCIES, // Towards the tasks a task waits on
+    DEPENDENTS    // Towards the tasks waiting on it
+};
+
+// Immutable compressed-sparse-row copy of the dependency graph. Both edge
+// directions are stored as one contiguous id array each, sliced by
+// offsets indexed by TaskId, so a traversal streams through flat arrays
+// instead of chasing node pointers. Every traversal is iterative and,
+// given workers, expands large frontiers in parallel.
+class FrozenGraph
+{
+public:
+    // Contiguous run of task ids usable in a range-based for loop
+    struct IdRange
+    {
+        const TaskId *first;
+        const TaskId *last;
+        const TaskId *begin() const { return first; }
+        const TaskId *end() const { return last; }
+        std::size_t size() const { return static_cast<std::size_t>(last - first); }
+    };
+
+private:
+    std::vector<std::uint64_t> dependencyStart; // TaskId -> offset into dependencyIds; one extra entry at the end
+    std::vector<TaskId> dependencyIds;
+    std::vector<std::uint64_t> dependentStart;
+    std::vector<TaskId> dependentIds;
+    std::vector<std::uint8_t> live; // Whether each TaskId holds a task
+    std::size_t vertices = 0;
+
+    // Run fn(first, last, worker) over [0, count), split across workers when large enough
+    template <typename Fn>
+    static void forEachChunk(std::size_t count, unsigned workers, Fn fn)
+    {
+        if (workers < 2 || count < kParallelLevelMin)
+        {
+            fn(std::size_t(0), count, 0u);
+            return;
+        }
+        std::vector<std::thread> threads;
+        for (unsigned w = 0; w < workers; ++w)
+            threads.emplace_back(fn, count * w / workers, count * (w + 1) / workers, w);
+        for (auto &thread : threads)
+            thread.join();
+    }
+
+    // Append the per-worker buffers to out and clear them
+    static void gather(std::vector<std::vector<TaskId>> &parts, std::vector<TaskId> &out)
+    {
+        for (auto &part : parts)
+        {
+            out.insert(out.end(), part.begin(), part.end());
+            part.clear();
+        }
+    }
+
+    IdRange neighbours(TaskId id, GraphDirection direction) const
+    {
+        if (direction == GraphDirection::DEPENDENCIES)
+            return IdRange{dependencyIds.data() + dependencyStart[id], dependencyIds.data() + dependencyStart[id + 1]};
+        return IdRange{dependentIds.data() + dependentStart[id], dependentIds.data() + dependentStart[id + 1]};
+    }
+
+public:
+    // Copy a graph whose ids lie below slotCount. nodeOf(id) returns the
+    // GraphNode of every id in liveIds.
+    template <typename NodeOf>
+    void rebuild(std::size_t slotCount, const std::vector<TaskId> &liveIds, NodeOf nodeOf, unsigned workers = 1)
+    {
+        vertices = liveIds.size();
+        live.assign(slotCount, 0);
+        dependencyStart.assign(slotCount + 1, 0);
+        dependentStart.assign(slotCount + 1, 0);
+        for (TaskId id : liveIds)
+        {
+            const GraphNode *node = nodeOf(id);
+            live[id] = 1;
+            dependencyStart[id + 1] = node->dependencies.size();
+            dependentStart[id + 1] = node->dependents.size();
+        }
+        for (std::size_t id = 0; id < slotCount; ++id)
+        {
+            dependencyStart[id + 1] += dependencyStart[id];
+            dependentStart[id + 1] += dependentStart[id];
+        }
+
+        // Offsets are known, so every task's edges can be copied independently
+        dependencyIds.resize(dependencyStart[slotCount]);
+        dependentIds.resize(dependentStart[slotCount]);
+        forEachChunk(liveIds.size(), workers, [&](std::size_t first, std::size_t last, unsigned)
+                     {
+            for (std::size_t i = first; i < last; ++i)
+            {
+                TaskId id = liveIds[i];
+                const GraphNode *node = nodeOf(id);
+                TaskId *out = dependencyIds.data() + dependencyStart[id];
+                for (const GraphNode *dep : node->dependencies)
+                    *out++ = dep->id;
+                out = dependentIds.data() + dependentStart[id];
+                for (const GraphNode *dependent : node->dependents)
+                    *out++ = dependent->id;
+            } });
+    }
+
+    std::size_t size() const
+    {
+        return vertices;
+    }
+
+    std::size_t edgeCount() const
+    {
+        return dependencyIds.size();
+    }
+
+    bool contains(TaskId id) const
+    {
+        return id < live.size() && live[id];
+    }
+
+    IdRange dependenciesOf(TaskId id) const
+    {
+        return neighbours(id, GraphDirection::DEPENDENCIES);
+    }
+
+    IdRange dependentsOf(TaskId id) const
+    {
+        return neighbours(id, GraphDirection::DEPENDENTS);
+    }
+
+    // Kahn's algorithm one level at a time: each level holds the tasks
+    // whose dependencies all lie in earlier levels, so a valid order comes
+    // out level by level; the order inside a level may differ between
+    // parallel runs. If levels is given, it receives the level of every
+    // task by TaskId. Returns fewer than size() tasks if the graph has a cycle.
+    std::vector<TaskId> topologicalOrder(unsigned workers = 1, std::vector<std::uint32_t> *levels = nullptr) const
+    {
+        std::unique_ptr<std::atomic<std::uint32_t>[]> pending(new std::atomic<std::uint32_t>[live.size()]);
+        std::vector<TaskId> order;
+        order.reserve(vertices);
+        for (TaskId id = 0; id < live.size(); ++id)
+        {
+            if (!live[id])
+                continue;
+            std::uint64_t degree = dependencyStart[id + 1] - dependencyStart[id];
+            pending[id].store(static_cast<std::uint32_t>(degree), std::memory_order_relaxed);
+            if (degree == 0)
+                order.push_back(id);
+        }
+        if (levels)
+            levels->assign(live.size(), 0);
+
+        std::vector<std::vector<TaskId>> parts(std::max(1u, workers));
+        std::size_t levelBegin = 0;
+        for (std::uint32_t level = 0; levelBegin < order.size(); ++level)
+        {
+            const std::size_t levelEnd = order.size();
+            forEachChunk(levelEnd - levelBegin, workers, [&](std::size_t first, std::size_t last, unsigned worker)
+                         {
+                for (std::size_t i = levelBegin + first; i < levelBegin + last; ++i)
+                {
+                    TaskId id = order[i];
+                    if (levels)
+                        (*levels)[id] = level;
+                    for (TaskId dependent : dependentsOf(id))
+                    {
+                        if (pending[dependent].fetch_sub(1, std::memory_order_acq_rel) == 1)
+                            parts[worker].push_back(dependent);
+                    }
+                } });
+            gather(parts, order);
+            levelBegin = levelEnd;
+        }
+        return order;
+    }
+
+    // Every task reachable from sources by following edges in direction,
+    // excluding the sources themselves, in breadth-first order. Frontiers
+    // large enough are expanded in parallel, claiming tasks atomically.
+    std::vector<TaskId> reachable(const std::vector<TaskId> &sources, GraphDirection direction, unsigned workers = 1) const
+    {
+        std::unique_ptr<std::atomic<std::uint8_t>[]> seen(new std::atomic<std::uint8_t>[live.size()]());
+        std::vector<TaskId> frontier;
+        for (TaskId id : sources)
+        {
+            if (contains(id) && seen[id].exchange(1, std::memory_order_relaxed) == 0)
+                frontier.push_back(id);
+        }
+
+        std::vector<TaskId> found;
+        std::vector<TaskId> next;
+        std::vector<std::vector<TaskId>> parts(std::max(1u, workers));
+        while (!frontier.empty())
+        {
+            forEachChunk(frontier.size(), workers, [&](std::size_t first, std::size_t last, unsigned worker)
+                         {
+                for (std::size_t i = first; i < last; ++i)
+                {
+                    for (TaskId neighbour : neighbours(frontier[i], direction))
+                    {
+                        if (seen[neighbour].load(std::memory_order_relaxed) == 0 && seen[neighbour].exchange(1, std::memory_order_relaxed) == 0)
+                            parts[worker].push_back(neighbour);
+                    }
+                } });
+            next.clear();
+            gather(parts, next);
+            found.insert(found.end(), next.begin(), next.end());
+            frontier.swap(next);
+        }
+        return found;
+    }
+
+    // Whether task to transitively depends on task from; a depth-first search with
+    // an explicit stack that stops as soon as it gets there
+    bool reaches(TaskId from, TaskId to) const
+    {
+        if (!contains(from) || !contains(to))
+            return false;
+        std::vector<std::uint8_t> seen(live.size(), 0);
+        std::vector<TaskId> stack{from};
+        seen[from] = 1;
+        while (!stack.empty())
+        {
+            TaskId current = stack.back();
+            stack.pop_back();
+            for (TaskId dependent : dependentsOf(current))
+            {
+                if (dependent == to)
+                    return true;
+                if (!seen[dependent])
+                {
+                    seen[dependent] = 1;
+                    stack.push_back(dependent);
+                }
+            }
+        }
+        return false;
+    }
+
+    std::size_t memoryBytes() const
+    {
+        return (dependencyStart.capacity() + dependentStart.capacity()) * sizeof(std::uint64_t) +
+               (dependencyIds.capacity() + dependentIds.capacity()) * sizeof(TaskId) + live.capacity();
+    }
+};
+
+// Task Manager class
+template <typename Policy>
+class BasicTaskManager
+{
+public:
+    BasicTaskManager() = default;
+    BasicTaskManager(const BasicTaskManager &) = delete;
+    BasicTaskManager &operator=(const BasicTaskManager &) = delete;
+    template <typename>
+    friend class BasicConcurrentTaskManager;
+
+    ~BasicTaskManager()
+    {
+        for (TaskId id : liveTasks)
+        {
+            nodeArena.destroy(id);
+            taskArena.destroy(id);
+        }
+    }
+
+private:
+    IndexedHeap<Task *, CompareTask<Policy>, TaskQueueSlot> taskQueue;       // Addressable priority queue for tasks
+    SlabArena<Task> taskArena;                                               // Task storage indexed by TaskId
+    SlabArena<GraphNode> nodeArena;                                          // Dependency graph nodes indexed by TaskId
+    std::vector<std::uint32_t> generations;                                  // Current generation of every id handed out
+    std::vector<TaskId> freeIds;                                             // Ids of deleted tasks, reused first
+    NameTable taskIndex;                                                     // Task name -> id
+    std::vector<TaskId> liveTasks;                                           // Contiguous list of live task ids
+    TaskColumns columns;                                                     // Numeric task fields by TaskId for batch re-scoring
+    int currentTime = 0;                                                     // Clock that deadlines are measured against
+    std::chrono::milliseconds clockUnit{0};                                  // Wall time per clock unit; zero leaves the clock manual
+    std::chrono::steady_clock::time_point clockStart;                        // Wall time at which the clock read clockStartTime
+    int clockStartTime = 0;
+    std::vector<int> rekeyAt;                                                // Clock value at which each task's aging band changes
+    std::vector<std::pair<int, TaskId>> agingQueue;                          // Min-heap of (rekeyAt, id); stale entries are skipped
+    TimingWheel deadlineWheel;                                               // Deadline timers, keyed by id * 2 + DeadlineEvent
+    std::function<void(Task &, DeadlineEvent)> deadlineHandler;              // Reaction to deadline events beyond flagging
+    std::size_t deadlineEvents[2] = {};                                      // Events fired, by DeadlineEvent
+    std::string snapshotPath;                                                // Where the menu saves snapshots
+    Journal *journal = nullptr;                                              // Mutation log, if durability is enabled
+    std::uint64_t appliedSequence = 0;                                       // Last journal record reflected in memory
+    std::uint64_t compactionBytes = 64u << 20;                               // Journal size that triggers compaction
+    IndexedHeap<GraphNode *, CompareNode<Policy>, ReadyQueueSlot> readyQueue; // Tasks whose dependencies have all finished
+    std::size_t completedCount = 0;                                          // Nodes the scheduler has already executed
+    unsigned parallelWorkers = 1;                                            // Worker threads used by executeTasks
+#ifdef TM_HAS_COROUTINES
+    std::vector<TaskBody> bodies;                                            // Coroutine body per TaskId; empty ones only wait for dependencies
+    unsigned asyncWorkers = 0;                                               // Coroutine pool used by executeTasks; 0 disables it
+#endif
+    std::vector<GraphNode *> topoOrder;                                      // Dependencies before dependents; nullptr marks a deleted slot
+    std::size_t topoHoles = 0;                                               // Deleted slots in topoOrder
+    unsigned visitEpoch = 0;                                                 // Current stamp for GraphNode::visitMark
+    bool scheduleValid = false;                                              // Schedule analysis is current and kept up to date
+    mutable TaskManagerStats opStats;                                        // Per-operation latency histograms
+    bool versioning = false;                                                 // Track changes for publishVersion once it has been called
+    std::vector<std::uint8_t> taskChange;                                    // TaskChange of every id since the last publish
+    std::vector<TaskId> changedTasks;                                        // Ids whose taskChange is set
+    PersistentTrie<TaskView> versionTasks;                                   // State of the next version, built on publish
+    PersistentTrie<std::vector<TaskId>> versionNames;
+    std::uint64_t versionEdit = 0;                                           // Edit number of the publish in progress
+    std::uint64_t versionNumber = 0;
+    mutable std::mutex versionLock;                                          // Guards publishedVersion; held only to copy it
+    std::shared_ptr<const TaskVersion> publishedVersion;
+    FrozenGraph frozen;                                                      // CSR copy of the graph, see frozenGraph
+    std::uint64_t graphEdits = 0;                                            // Bumped whenever tasks or edges change
+    std::uint64_t frozenEdits = ~std::uint64_t(0);                           // graphEdits when frozen was built
+
+    enum TaskChange : std::uint8_t
+    {
+        UNCHANGED,
+        CHANGED,
+        REMOVED
+    };
+
+    // Note that a task differs from the last published version. Only the
+    // latest change matters, since publishVersion reads the task itself.
+    void markChanged(TaskId id, TaskChange change = CHANGED)
+    {
+        if (!versioning)
+            return;
+        if (taskChange.size() <= id)
+            taskChange.resize(std::max<std::size_t>(id + 1, generations.size()), UNCHANGED);
+        if (taskChange[id] == UNCHANGED)
+            changedTasks.push_back(id);
+        if (taskChange[id] == UNCHANGED || change == REMOVED || taskChange[id] == REMOVED)
+            taskChange[id] = change;
+    }
+
+    std::shared_ptr<const TaskView> makeTaskView(TaskId id) const
+    {
+        const Task *task = taskArena.at(id);
+        const GraphNode *node = nodeArena.at(id);
+        auto view = std::make_shared<TaskView>();
+        view->id = id;
+        view->generation = generations[id];
+        view->name = task->name;
+        view->description = task->description;
+        view->deadline = task->deadline;
+        view->completion = task->completion;
+        view->duration = task->duration;
+        view->status = task->status;
+        view->priority = task->priority;
+        view->completed = node->completed;
+        view->approaching = task->approaching;
+        view->overdue = task->overdue;
+        view->dependencies.reserve(node->dependencies.size());
+        for (const GraphNode *dep : node->dependencies)
+            view->dependencies.push_back(dep->id);
+        return view;
+    }
+
+    // Add or drop id in the name bucket of the version being built
+    void updateVersionName(const std::string &name, TaskId id, bool add)
+    {
+        std::uint32_t key = nameKey(name);
+        const std::vector<TaskId> *bucket = versionNames.find(key);
+        auto ids = bucket ? std::make_shared<std::vector<TaskId>>(*bucket) : std::make_shared<std::vector<TaskId>>();
+        if (add)
+            ids->push_back(id);
+        else
+            ids->erase(std::remove(ids->begin(), ids->end(), id), ids->end());
+        versionNames.assign(key, ids->empty() ? nullptr : std::move(ids), versionEdit);
+    }
+
+    // Mark a node as finished and release the dependents that were only waiting on it
+    void completeNode(GraphNode *node)
+    {
+        if (node->completed)
+            return;
+        node->completed = true;
+        ++completedCount;
+        markChanged(node->id);
+        readyQueue.erase(node);
+        cancelDeadlineTimers(node->id);
+        for (GraphNode *dependent : node->dependents)
+        {
+            if (!dependent->completed && --dependent->pendingDependencies == 0)
+                readyQueue.push(dependent);
+        }
+    }
+
+    // Unlink a node from its neighbours, the scheduler state and the
+    // topological order before it is deleted. Thanks to the reverse edges
+    // only the node's own neighbours are touched: O(degree).
+    void detachNode(GraphNode *node)
+    {
+        ++graphEdits;
+        topoOrder[node->topoIndex] = nullptr;
+        if (++topoHoles > topoOrder.size() / 2)
+            compactTopoOrder();
+
+        readyQueue.erase(node);
+        if (node->completed)
+            --completedCount;
+
+        for (GraphNode *dep : node->dependencies)
+        {
+            auto &rev = dep->dependents;
+            rev.erase(std::remove(rev.begin(), rev.end(), node), rev.end());
+        }
+
+        for (GraphNode *dependent : node->dependents)
+        {
+            auto &fwd = dependent->dependencies;
+            fwd.erase(std::remove(fwd.begin(), fwd.end(), node), fwd.end());
+            markChanged(dependent->id);
+            if (!node->completed && !dependent->completed && --dependent->pendingDependencies == 0)
+                readyQueue.push(dependent);
+        }
+    }
+
+    // Allocate an id and build the task, its graph node and its column
+    // entries. The caller inserts the task into the heaps. Returns
+    // kInvalidTaskId if a task with that name already exists.
+    TaskId createTask(std::string name, std::string description, int deadline, double completion, int duration = kDefaultDuration)
+    {
+        TaskId id;
+        if (!freeIds.empty())
+        {
+            id = freeIds.back();
+            freeIds.pop_back();
+        }
+        else
+        {
+            id = static_cast<TaskId>(generations.size());
+            generations.push_back(0);
+        }
+
+        Task *task = taskArena.emplace(id, std::move(name), std::move(description), deadline, completion);
+        if (!taskIndex.insert(task->getName(), id))
+        {
+            taskArena.destroy(id);
+            freeIds.push_back(id);
+            return kInvalidTaskId;
+        }
+        task->taskId = id;
+        task->duration = duration;
+        if (currentTime != 0)
+            task->deadlineFactor = task->calculateDeadlineFactor(currentTime);
+        task->priority = Policy::score(*task);
+
+        if (columns.size() < generations.size())
+            columns.resize(generations.size());
+        if (rekeyAt.size() < generations.size())
+            rekeyAt.resize(generations.size(), kNeverAges);
+        columns.deadline[id] = static_cast<float>(deadline);
+        columns.completion[id] = task->completionFactor;
+
+        GraphNode *newNode = nodeArena.emplace(id);
+        newNode->task = task;
+        newNode->id = id;
+        newNode->livePos = liveTasks.size();
+        liveTasks.push_back(id);
+        newNode->topoIndex = topoOrder.size();
+        topoOrder.push_back(newNode);
+        scheduleAging(id);
+        armDeadlineTimers(id);
+        markChanged(id);
+        ++graphEdits;
+        if (scheduleValid)
+        {
+            computeEarliest(newNode);
+            computeLatest(newNode);
+        }
+        return id;
+    }
+
+    static std::uint32_t deadlineKey(TaskId id, DeadlineEvent event)
+    {
+        return id * 2 + static_cast<std::uint32_t>(event);
+    }
+
+    // Flag the task and hand the event to the handler
+    void raiseDeadlineEvent(TaskId id, DeadlineEvent event)
+    {
+        Task *task = taskArena.at(id);
+        if (event == DeadlineEvent::OVERDUE)
+        {
+            task->overdue = true;
+            TM_LOG(DEBUG, "Task '" << task->getName() << "' is overdue.");
+        }
+        else
+        {
+            task->approaching = true;
+            TM_LOG(DEBUG, "Task '" << task->getName() << "' is due within " << kDeadlineWarningLead << " units.");
+        }
+        ++deadlineEvents[static_cast<int>(event)];
+        markChanged(id);
+        if (deadlineHandler)
+            deadlineHandler(*task, event);
+    }
+
+    // Arm both deadline timers of an unfinished task; an event whose time
+    // has already come fires at once
+    void armDeadlineTimers(TaskId id)
+    {
+        int deadline = taskArena.at(id)->getDeadline();
+        if (deadline < currentTime)
+        {
+            raiseDeadlineEvent(id, DeadlineEvent::OVERDUE);
+            return;
+        }
+        if (deadline < std::numeric_limits<int>::max())
+            deadlineWheel.schedule(deadlineKey(id, DeadlineEvent::OVERDUE), deadline + 1);
+        if (!deadlineWheel.schedule(deadlineKey(id, DeadlineEvent::APPROACHING), deadline - kDeadlineWarningLead))
+            raiseDeadlineEvent(id, DeadlineEvent::APPROACHING);
+    }
+
+    void cancelDeadlineTimers(TaskId id)
+    {
+        deadlineWheel.cancel(deadlineKey(id, DeadlineEvent::APPROACHING));
+        deadlineWheel.cancel(deadlineKey(id, DeadlineEvent::OVERDUE));
+    }
+
+    // Bring the deadline wheel up to the clock, firing what expired on the
+    // way. A clock that moved backwards re-arms every timer instead.
+    void fireDeadlineEvents()
+    {
+        bool forward = deadlineWheel.advance(currentTime, [this](std::uint32_t key)
+                                             { raiseDeadlineEvent(key / 2, static_cast<DeadlineEvent>(key % 2)); });
+        if (forward)
+            return;
+        deadlineWheel.reset(currentTime);
+        for (TaskId id : liveTasks)
+        {
+            Task *task = taskArena.at(id);
+            task->approaching = task->overdue = false;
+            if (!nodeArena.at(id)->completed)
+                armDeadlineTimers(id);
+        }
+    }
+
+    // Queue the next band change of a task, unless its score no longer ages
+    void scheduleAging(TaskId id)
+    {
+        int at = nextAgingTime(taskArena.at(id)->getDeadline(), currentTime);
+        rekeyAt[id] = at;
+        if (at == kNeverAges)
+            return;
+        agingQueue.emplace_back(at, id);
+        std::push_heap(agingQueue.begin(), agingQueue.end(), std::greater<>());
+    }
+
+    // Recompute every band change from scratch in O(n)
+    void rebuildAgingQueue()
+    {
+        agingQueue.clear();
+        for (TaskId id : liveTasks)
+        {
+            rekeyAt[id] = nextAgingTime(taskArena.at(id)->getDeadline(), currentTime);
+            if (rekeyAt[id] != kNeverAges)
+                agingQueue.emplace_back(rekeyAt[id], id);
+        }
+        std::make_heap(agingQueue.begin(), agingQueue.end(), std::greater<>());
+    }
+
+    // Re-score one task at the current clock and restore its heap positions
+    void rescoreTask(Task *task)
+    {
+        task->deadlineFactor = task->calculateDeadlineFactor(currentTime);
+        task->priority = Policy::score(*task);
+        taskQueue.update(task);
+        readyQueue.update(nodeArena.at(task->getId()));
+        markChanged(task->getId());
+    }
+
+    // Re-key only the tasks whose aging band changed since the clock last
+    // moved: O(k log n) for k crossings instead of a pass over every task.
+    // When too many are due at once a single batch re-score is cheaper.
+    void ageDueTasks()
+    {
+        std::size_t limit = liveTasks.size() / kIncrementalBatchRatio + 1;
+        std::vector<TaskId> due;
+        while (!agingQueue.empty() && agingQueue.front().first <= currentTime)
+        {
+            auto [at, id] = agingQueue.front();
+            std::pop_heap(agingQueue.begin(), agingQueue.end(), std::greater<>());
+            agingQueue.pop_back();
+            if (rekeyAt[id] != at)
+                continue; // Deleted or already re-keyed
+            rekeyAt[id] = kNeverAges;
+            due.push_back(id);
+            if (due.size() > limit)
+            {
+                rescoreAllTasks();
+                return;
+            }
+        }
+        for (TaskId id : due)
+        {
+            rescoreTask(taskArena.at(id));
+            scheduleAging(id);
+        }
+    }
+
+    // Move the clock and age the scores; a clock moving backwards
+    // invalidates every band, so it re-scores everything
+    void moveClock(int ticks)
+    {
+        currentTime += ticks;
+        if (journal)
+            journal->logClock(ticks);
+        if (ticks < 0)
+            rescoreAllTasks();
+        else
+            ageDueTasks();
+        fireDeadlineEvents();
+        scheduleValid = false; // Every earliest start moves with the clock
+    }
+
+    // Delete a task and unlink it from every structure
+    void removeTask(TaskId id)
+    {
+        Task *taskToDelete = taskArena.at(id);
+        GraphNode *nodeToDelete = nodeArena.at(id);
+
+        // Neighbours whose schedule depended on this node, refreshed once it is gone
+        std::vector<GraphNode *> dependents;
+        std::vector<GraphNode *> dependencies;
+        if (scheduleValid)
+        {
+            dependents = nodeToDelete->dependents;
+            dependencies = nodeToDelete->dependencies;
+        }
+
+        // Remove the task from the name index before its name is destroyed
+        taskIndex.erase(taskToDelete->getName());
+
+        // Swap-remove the id from the live list
+        TaskId moved = liveTasks.back();
+        liveTasks[nodeToDelete->livePos] = moved;
+        nodeArena.at(moved)->livePos = nodeToDelete->livePos;
+        liveTasks.pop_back();
+
+        // Remove the task from the priority queue taskQueue
+        taskQueue.erase(taskToDelete);
+
+        // Remove all edges to and from this task
+        detachNode(nodeToDelete);
+
+        nodeArena.destroy(id);
+        taskArena.destroy(id);
+
+        // Invalidate outstanding handles and recycle the id
+        ++generations[id];
+        freeIds.push_back(id);
+        rekeyAt[id] = kNeverAges;
+        cancelDeadlineTimers(id);
+        markChanged(id, REMOVED);
+#ifdef TM_HAS_COROUTINES
+        if (id < bodies.size())
+            bodies[id] = nullptr;
+#endif
+        if (agingQueue.size() > 2 * liveTasks.size() + 1024)
+            rebuildAgingQueue(); // Mostly entries of deleted tasks
+
+        if (scheduleValid)
+        {
+            propagateEarliest(dependents);
+            propagateLatest(dependencies);
+        }
+    }
+
+    // Make room for count more tasks in every per-task container
+    void reserveTasks(std::size_t count)
+    {
+        std::size_t total = liveTasks.size() + count;
+        taskIndex.reserve(total);
+        liveTasks.reserve(total);
+        generations.reserve(total);
+        topoOrder.reserve(topoOrder.size() + count);
+        taskQueue.reserve(total);
+        readyQueue.reserve(total);
+        if (columns.size() < total)
+            columns.resize(total);
+        if (rekeyAt.size() < total)
+            rekeyAt.resize(total, kNeverAges);
+        agingQueue.reserve(total);
+        deadlineWheel.reserve(2 * total);
+    }
+
+    // Link dep -> node, keeping the topological order and the scheduler
+    // state in sync. Returns false, changing nothing, if the edge would
+    // create a cycle.
+    bool insertEdge(GraphNode *node, GraphNode *dep)
+    {
+        if (node == dep || (dep->topoIndex > node->topoIndex && !reorderForEdge(dep, node)))
+            return false;
+
+        linkNodes(node, dep);
+        if (scheduleValid)
+        {
+            propagateEarliest({node});
+            propagateLatest({dep});
+        }
+        return true;
+    }
+
+    // Add the edge dep -> node to both adjacency lists and the scheduler
+    // state; the caller keeps the topological order valid
+    void linkNodes(GraphNode *node, GraphNode *dep)
+    {
+        node->dependencies.push_back(dep);
+        dep->dependents.push_back(node);
+        markChanged(node->id);
+        ++graphEdits;
+
+        // The task is blocked until the new dependency finishes
+        if (!node->completed && !dep->completed && node->pendingDependencies++ == 0)
+            readyQueue.erase(node);
+    }
+
+    // Tasks named inside applyBatch: an existing TaskId, kBatchAdded plus
+    // the index of a task the batch adds, or kBatchMissing
+    using BatchRef = std::uint64_t;
+    static constexpr BatchRef kBatchAdded = BatchRef(1) << 32;
+    static constexpr BatchRef kBatchMissing = ~BatchRef(0);
+
+    // Cycle check and topological-order update for a batch, run before it
+    // changes anything. Only edges that run against the current order can
+    // close a cycle. Each such edge spans a window of positions, and every
+    // task on a cycle lies inside one group of overlapping windows, so
+    // each group is sorted on its own with Kahn's algorithm, on the graph
+    // as the batch will leave it. Returns false on a cycle; otherwise order
+    // holds the tasks of every group, group by group, in a valid order for
+    // the group's slots. Added tasks count as appended to the order in
+    // batch order; deleted nodes carry visitMark == deletedMark.
+    bool orderBatchWindows(const std::vector<std::pair<BatchRef, BatchRef>> &edges, const std::vector<bool> &addedAlive,
+                           unsigned deletedMark, std::vector<BatchRef> &order)
+    {
+        auto alive = [&](BatchRef ref)
+        { return ref & kBatchAdded ? addedAlive[ref - kBatchAdded] : nodeArena.at(static_cast<TaskId>(ref))->visitMark != deletedMark; };
+        auto position = [&](BatchRef ref)
+        { return ref & kBatchAdded ? topoOrder.size() + (ref - kBatchAdded) : nodeArena.at(static_cast<TaskId>(ref))->topoIndex; };
+
+        // Merge the spans of the violating edges into disjoint windows
+        order.clear();
+        std::vector<std::pair<std::size_t, std::size_t>> windows;
+        for (const auto &edge : edges)
+        {
+            if (alive(edge.first) && alive(edge.second) && position(edge.second) > position(edge.first))
+                windows.emplace_back(position(edge.first), position(edge.second));
+        }
+        if (windows.empty())
+            return true; // Every new edge already agrees with the order
+        std::sort(windows.begin(), windows.end());
+        std::size_t merged = 0;
+        for (std::size_t i = 1; i < windows.size(); ++i)
+        {
+            if (windows[i].first <= windows[merged].second)
+                windows[merged].second = std::max(windows[merged].second, windows[i].second);
+            else
+                windows[++merged] = windows[i];
+        }
+        windows.resize(merged + 1);
+
+        // Window holding a position, or windows.size() if none does
+        auto windowOf = [&](std::size_t pos)
+        {
+            auto it = std::upper_bound(windows.begin(), windows.end(), std::make_pair(pos, std::numeric_limits<std::size_t>::max()));
+            if (it == windows.begin() || (it - 1)->second < pos)
+                return windows.size();
+            return static_cast<std::size_t>(it - 1 - windows.begin());
+        };
+
+        // Batch edges with both ends inside the same window, grouped by window
+        std::vector<std::vector<std::pair<std::size_t, std::size_t>>> windowEdges(windows.size()); // (from, to) positions
+        for (const auto &edge : edges)
+        {
+            if (!alive(edge.first) || !alive(edge.second))
+                continue;
+            std::size_t from = position(edge.second);
+            std::size_t to = position(edge.first);
+            std::size_t window = windowOf(from);
+            if (window < windows.size() && window == windowOf(to))
+                windowEdges[window].emplace_back(from, to);
+        }
+
+        for (std::size_t w = 0; w < windows.size(); ++w)
+        {
+            const std::size_t lower = windows[w].first;
+            const std::size_t upper = windows[w].second;
+            const std::size_t width = upper - lower + 1;
+            std::vector<BatchRef> slots(width, kBatchMissing);
+            std::size_t members = 0;
+            for (std::size_t pos = lower; pos <= upper && pos < topoOrder.size(); ++pos)
+            {
+                GraphNode *node = topoOrder[pos];
+                if (node && node->visitMark != deletedMark)
+                {
+                    slots[pos - lower] = node->id;
+                    ++members;
+                }
+            }
+            for (std::size_t pos = std::max(lower, topoOrder.size()); pos <= upper; ++pos)
+            {
+                if (addedAlive[pos - topoOrder.size()])
+                {
+                    slots[pos - lower] = kBatchAdded + (pos - topoOrder.size());
+                    ++members;
+                }
+            }
+
+            // Existing edges come from the adjacency lists, the batch's from
+            // a CSR by dependency
+            auto local = [&](const GraphNode *node)
+            { return node->topoIndex >= lower && node->topoIndex <= upper && node->visitMark != deletedMark; };
+            std::vector<std::uint32_t> inDegree(width, 0);
+            std::vector<std::uint32_t> outStart(width + 1, 0);
+            std::vector<std::uint32_t> outTarget(windowEdges[w].size());
+            for (const auto &edge : windowEdges[w])
+            {
+                ++outStart[edge.first - lower + 1];
+                ++inDegree[edge.second - lower];
+            }
+            for (std::size_t i = 0; i < width; ++i)
+                outStart[i + 1] += outStart[i];
+            {
+                std::vector<std::uint32_t> fill(outStart.begin(), outStart.end() - 1);
+                for (const auto &edge : windowEdges[w])
+                    outTarget[fill[edge.first - lower]++] = static_cast<std::uint32_t>(edge.second - lower);
+            }
+            for (std::size_t i = 0; i < width; ++i)
+            {
+                if (slots[i] == kBatchMissing || slots[i] & kBatchAdded)
+                    continue;
+                for (const GraphNode *dep : nodeArena.at(static_cast<TaskId>(slots[i]))->dependencies)
+                {
+                    if (local(dep))
+                        ++inDegree[i];
+                }
+            }
+
+            std::vector<std::uint32_t> queue;
+            queue.reserve(members);
+            for (std::size_t i = 0; i < width; ++i)
+            {
+                if (slots[i] != kBatchMissing && inDegree[i] == 0)
+                    queue.push_back(static_cast<std::uint32_t>(i));
+            }
+            for (std::size_t head = 0; head < queue.size(); ++head)
+            {
+                std::uint32_t current = queue[head];
+                if (!(slots[current] & kBatchAdded))
+                {
+                    for (const GraphNode *dependent : nodeArena.at(static_cast<TaskId>(slots[current]))->dependents)
+                    {
+                        if (local(dependent) && --inDegree[dependent->topoIndex - lower] == 0)
+                            queue.push_back(static_cast<std::uint32_t>(dependent->topoIndex - lower));
+                    }
+                }
+                for (std::uint32_t i = outStart[current]; i < outStart[current + 1]; ++i)
+                {
+                    if (--inDegree[outTarget[i]] == 0)
+                        queue.push_back(outTarget[i]);
+                }
+            }
+            if (queue.size() != members)
+            {
+                order.clear();
+                return false;
+            }
+            for (std::uint32_t i : queue)
+                order.push_back(slots[i]);
+        }
+        return true;
+    }
+
+    // Recompute topoOrder from scratch with Kahn's algorithm, keeping the
+    // current relative order where the edges allow it. Returns false and
+    // leaves the order untouched if the graph has a cycle.
+    bool rebuildTopoOrder()
+    {
+        std::vector<std::uint32_t> inDegree(generations.size(), 0);
+        std::vector<GraphNode *> order;
+        order.reserve(liveTasks.size());
+        for (GraphNode *node : topoOrder)
+        {
+            if (!node)
+                continue;
+            inDegree[node->id] = static_cast<std::uint32_t>(node->dependencies.size());
+            if (inDegree[node->id] == 0)
+                order.push_back(node);
+        }
+
+        for (std::size_t head = 0; head < order.size(); ++head)
+        {
+            for (GraphNode *dependent : order[head]->dependents)
+            {
+                if (--inDegree[dependent->id] == 0)
+                    order.push_back(dependent);
+            }
+        }
+
+        if (order.size() != liveTasks.size())
+            return false;
+        for (std::size_t i = 0; i < order.size(); ++i)
+            order[i]->topoIndex = i;
+        topoOrder.swap(order);
+        topoHoles = 0;
+        return true;
+    }
+
+    std::vector<Task *> reachableTasks(const std::string &taskName, GraphDirection direction)
+    {
+        std::vector<Task *> tasks;
+        TaskId id = taskIndex.find(taskName);
+        if (id == kInvalidTaskId)
+            return tasks;
+        unsigned workers = parallelWorkers > 1 ? parallelWorkers : std::max(1u, std::thread::hardware_concurrency());
+        for (TaskId found : frozenGraph().reachable({id}, direction, workers))
+            tasks.push_back(taskArena.at(found));
+        return tasks;
+    }
+
+    GraphNode *findNode(std::string_view name) const
+    {
+        TaskId id = taskIndex.find(name);
+        return id == kInvalidTaskId ? nullptr : nodeArena.at(id);
+    }
+
+    // Squeeze deleted slots out of topoOrder, keeping the relative order
+    void compactTopoOrder()
+    {
+        std::size_t next = 0;
+        for (GraphNode *node : topoOrder)
+        {
+            if (node)
+            {
+                node->topoIndex = next;
+                topoOrder[next++] = node;
+            }
+        }
+        topoOrder.resize(next);
+        topoHoles = 0;
+    }
+
+    unsigned nextVisitEpoch()
+    {
+        if (++visitEpoch == 0)
+        {
+            // Stamp wrapped around; reset every node so stale marks cannot match
+            for (GraphNode *node : topoOrder)
+                if (node)
+                    node->visitMark = 0;
+            visitEpoch = 1;
+        }
+        return visitEpoch;
+    }
+
+    // Work left on a task in clock units: its duration scaled by the part
+    // not yet completed, zero once the scheduler has executed it
+    static std::int64_t remainingWork(const GraphNode *node)
+    {
+        if (node->completed)
+            return 0;
+        double left = 1.0 - std::clamp(node->task->completion, 0.0, 1.0);
+        return static_cast<std::int64_t>(std::ceil(node->task->duration * left));
+    }
+
+    // Forward pass step: start once the clock and every dependency allow it
+    void computeEarliest(GraphNode *node) const
+    {
+        std::int64_t start = currentTime;
+        for (GraphNode *dep : node->dependencies)
+            start = std::max(start, dep->earliestFinish);
+        node->earliestStart = start;
+        node->earliestFinish = start + remainingWork(node);
+    }
+
+    // Backward pass step: finish by the task's own deadline and in time for
+    // every dependent to start at its latest start
+    static void computeLatest(GraphNode *node)
+    {
+        std::int64_t finish = node->task->deadline;
+        for (GraphNode *dependent : node->dependents)
+            finish = std::min(finish, dependent->latestStart);
+        node->latestFinish = finish;
+        node->latestStart = finish - remainingWork(node);
+    }
+
+    static std::int64_t slackOf(const GraphNode *node)
+    {
+        return node->latestStart - node->earliestStart;
+    }
+
+    // Run fn over nodes, split across workers when the batch is large enough
+    template <typename Fn>
+    static void forEachNode(GraphNode *const *nodes, std::size_t count, unsigned workers, Fn fn)
+    {
+        if (workers < 2 || count < kParallelLevelMin)
+        {
+            for (std::size_t i = 0; i < count; ++i)
+                fn(nodes[i]);
+            return;
+        }
+        std::vector<std::thread> threads;
+        for (unsigned w = 0; w < workers; ++w)
+        {
+            std::size_t first = count * w / workers;
+            std::size_t last = count * (w + 1) / workers;
+            threads.emplace_back([=]
+                                 {
+                for (std::size_t i = first; i < last; ++i)
+                    fn(nodes[i]); });
+        }
+        for (auto &thread : threads)
+            thread.join();
+    }
+
+    // Re-run the forward pass from the seeds. Nodes are visited in
+    // topological order (min-heap on topoIndex), so each is recomputed once,
+    // after all of its changed dependencies; the walk stops wherever an
+    // earliest finish comes out unchanged.
+    void propagateEarliest(const std::vector<GraphNode *> &seeds)
+    {
+        auto later = [](const GraphNode *a, const GraphNode *b)
+        { return a->topoIndex > b->topoIndex; };
+        const unsigned epoch = nextVisitEpoch();
+        std::vector<GraphNode *> heap;
+        for (GraphNode *seed : seeds)
+        {
+            if (seed->visitMark != epoch)
+            {
+                seed->visitMark = epoch;
+                heap.push_back(seed);
+            }
+        }
+        std::make_heap(heap.begin(), heap.end(), later);
+        while (!heap.empty())
+        {
+            std::pop_heap(heap.begin(), heap.end(), later);
+            GraphNode *node = heap.back();
+            heap.pop_back();
+            std::int64_t before = node->earliestFinish;
+            computeEarliest(node);
+            if (node->earliestFinish == before)
+                continue;
+            for (GraphNode *dependent : node->dependents)
+            {
+                if (dependent->visitMark != epoch)
+                {
+                    dependent->visitMark = epoch;
+                    heap.push_back(dependent);
+                    std::push_heap(heap.begin(), heap.end(), later);
+                }
+            }
+        }
+    }
+
+    // Mirror of propagateEarliest for the backward pass: reverse
+    // topological order, following dependencies while latest starts change
+    void propagateLatest(const std::vector<GraphNode *> &seeds)
+    {
+        auto earlier = [](const GraphNode *a, const GraphNode *b)
+        { return a->topoIndex < b->topoIndex; };
+        const unsigned epoch = nextVisitEpoch();
+        std::vector<GraphNode *> heap;
+        for (GraphNode *seed : seeds)
+        {
+            if (seed->visitMark != epoch)
+            {
+                seed->visitMark = epoch;
+                heap.push_back(seed);
+            }
+        }
+        std::make_heap(heap.begin(), heap.end(), earlier);
+        while (!heap.empty())
+        {
+            std::pop_heap(heap.begin(), heap.end(), earlier);
+            GraphNode *node = heap.back();
+            heap.pop_back();
+            std::int64_t before = node->latestStart;
+            computeLatest(node);
+            if (node->latestStart == before)
+                continue;
+            for (GraphNode *dep : node->dependencies)
+            {
+                if (dep->visitMark != epoch)
+                {
+                    dep->visitMark = epoch;
+                    heap.push_back(dep);
+                    std::push_heap(heap.begin(), heap.end(), earlier);
+                }
+            }
+        }
+    }
+
+    // Bring the analysis up to date after the remaining work or the edges
+    // of node changed. Does nothing until the first full analysis.
+    void updateSchedule(GraphNode *node)
+    {
+        if (!scheduleValid)
+            return;
+        propagateEarliest({node});
+        propagateLatest({node});
+    }
+
+    // Pearce-Kelly: called when the new edge dep -> node violates the current
+    // order (dep is placed after node). Only nodes whose position lies between
+    // the two endpoints are visited and reordered. Returns false, leaving the
+    // order untouched, when the edge would close a cycle.
+    bool reorderForEdge(GraphNode *dep, GraphNode *node)
+    {
+        const std::size_t lower = node->topoIndex;
+        const std::size_t upper = dep->topoIndex;
+        const unsigned epoch = nextVisitEpoch();
+        std::vector<GraphNode *> stack;
+
+        // Forward search: everything that (transitively) waits on node
+        std::vector<GraphNode *> forward;
+        node->visitMark = epoch;
+        stack.push_back(node);
+        while (!stack.empty())
+        {
+            GraphNode *current = stack.back();
+            stack.pop_back();
+            forward.push_back(current);
+            for (GraphNode *next : current->dependents)
+            {
+                if (next == dep)
+                    return false;
+                if (next->visitMark != epoch && next->topoIndex < upper)
+                {
+                    next->visitMark = epoch;
+                    stack.push_back(next);
+                }
+            }
+        }
+
+        // Backward search: everything dep (transitively) waits on
+        std::vector<GraphNode *> backward;
+        dep->visitMark = epoch;
+        stack.push_back(dep);
+        while (!stack.empty())
+        {
+            GraphNode *current = stack.back();
+            stack.pop_back();
+            backward.push_back(current);
+            for (GraphNode *prev : current->dependencies)
+            {
+                if (prev->visitMark != epoch && prev->topoIndex > lower)
+                {
+                    prev->visitMark = epoch;
+                    stack.push_back(prev);
+                }
+            }
+        }
+
+        // Reuse the freed positions: the backward set first, then the forward set
+        auto byIndex = [](GraphNode *a, GraphNode *b)
+        { return a->topoIndex < b->topoIndex; };
+        std::sort(forward.begin(), forward.end(), byIndex);
+        std::sort(backward.begin(), backward.end(), byIndex);
+
+        std::vector<std::size_t> slots;
+        slots.reserve(forward.size() + backward.size());
+        for (GraphNode *n : backward)
+            slots.push_back(n->topoIndex);
+        for (GraphNode *n : forward)
+            slots.push_back(n->topoIndex);
+        std::sort(slots.begin(), slots.end());
+
+        std::size_t i = 0;
+        for (GraphNode *n : backward)
+        {
+            n->topoIndex = slots[i++];
+            topoOrder[n->topoIndex] = n;
+        }
+        for (GraphNode *n : forward)
+        {
+            n->topoIndex = slots[i++];
+            topoOrder[n->topoIndex] = n;
+        }
+        return true;
+    }
+
+public:
+    // Tasks in dependency order (every task after the tasks it depends on).
+    // The order is maintained incrementally, so this is a plain O(V) walk.
+    std::vector<Task *> topologicalSort() const
+    {
+        std::vector<Task *> sortedTasks;
+        sortedTasks.reserve(topoOrder.size() - topoHoles);
+        for (GraphNode *node : topoOrder)
+        {
+            if (node)
+                sortedTasks.push_back(node->task);
+        }
+        return sortedTasks;
+    }
+
+    // Copy the dependency graph into out as CSR arrays, in parallel on
+    // workers threads for large graphs
+    void freezeGraph(FrozenGraph &out, unsigned workers = 1) const
+    {
+        out.rebuild(generations.size(), liveTasks, [this](TaskId id)
+                    { return nodeArena.at(id); }, workers);
+    }
+
+    // CSR copy of the current graph for read-only traversals, rebuilt on
+    // first use after tasks or edges changed. Status changes do not affect
+    // it. The reference stays valid until the next call.
+    const FrozenGraph &frozenGraph()
+    {
+        if (frozenEdits != graphEdits)
+        {
+            freezeGraph(frozen, parallelWorkers > 1 ? parallelWorkers : std::max(1u, std::thread::hardware_concurrency()));
+            frozenEdits = graphEdits;
+        }
+        return frozen;
+    }
+
+    // Every task that transitively waits on taskName: what a delay there holds up
+    std::vector<Task *> downstreamOf(const std::string &taskName)
+    {
+        return reachableTasks(taskName, GraphDirection::DEPENDENTS);
+    }
+
+    // Every task taskName transitively waits on
+    std::vector<Task *> upstreamOf(const std::string &taskName)
+    {
+        return reachableTasks(taskName, GraphDirection::DEPENDENCIES);
+    }
+
+    // Create a task in place and register it with the queue and the graph.
+    // Returns an invalid handle if a task with that name already exists.
+    TaskHandle addTask(const std::string &name, const std::string &description, int deadline, double completion, int duration = kDefaultDuration)
+    {
+        OpTimer timer(opStats, StatOp::ADD_TASK);
+        TaskId id = createTask(name, description, deadline, completion, duration);
+        if (id == kInvalidTaskId)
+        {
+            TM_LOG(WARN, "Task '" << name << "' already exists.");
+            return TaskHandle();
+        }
+
+        // Push the new task onto the priority queue; a new task has no
+        // dependencies yet, so it is immediately ready
+        taskQueue.push(taskArena.at(id));
+        readyQueue.push(nodeArena.at(id));
+        if (journal)
+        {
+            journal->logAddTask(name, description, deadline, completion);
+            if (duration != kDefaultDuration)
+                journal->logDuration(name, duration);
+        }
+        return TaskHandle{id, generations[id]};
+    }
+
+    // Add many tasks at once. Every structure is appended to without
+    // ordering work and each heap is restored by a single heapify at the
+    // end (small batches are sifted in instead). Records whose name
+    // already exists are skipped.
+    std::size_t addTasksBulk(std::vector<TaskRecord> &records)
+    {
+        OpTimer timer(opStats, StatOp::BULK_ADD);
+        std::size_t added = 0;
+        const bool heapify = records.size() * kIncrementalBatchRatio >= liveTasks.size();
+        if (heapify)
+            reserveTasks(records.size()); // Exact reservations would defeat geometric growth for small batches
+
+        for (TaskRecord &record : records)
+        {
+            TaskId id = createTask(std::move(record.name), std::move(record.description), record.deadline, record.completion, record.duration);
+            if (id == kInvalidTaskId)
+                continue;
+            if (heapify)
+            {
+                taskQueue.pushUnordered(taskArena.at(id));
+                readyQueue.pushUnordered(nodeArena.at(id));
+            }
+            else
+            {
+                taskQueue.push(taskArena.at(id));
+                readyQueue.push(nodeArena.at(id));
+            }
+            if (journal)
+            {
+                const Task *task = taskArena.at(id);
+                journal->logAddTask(task->name, task->description, task->deadline, task->completion);
+                if (task->duration != kDefaultDuration)
+                    journal->logDuration(task->name, task->duration);
+            }
+            ++added;
+        }
+
+        if (heapify)
+        {
+            taskQueue.rebuild();
+            readyQueue.rebuild();
+        }
+        return added;
+    }
+
+    // Add many dependency edges (task, dependency) at once. All edges are
+    // linked first and the topological order is recomputed with one Kahn
+    // pass. If the batch contains a cycle, the batch is unlinked again and
+    // its edges are inserted one at a time so only the cycle-closing ones
+    // are rejected. Returns the number of edges added.
+    std::size_t addDependenciesBulk(const std::vector<std::pair<std::string, std::string>> &edges)
+    {
+        OpTimer timer(opStats, StatOp::BULK_DEPENDENCIES);
+        // A few edges against a large graph are cheaper to order one at a
+        // time incrementally than with a full Kahn pass
+        if (edges.size() * kIncrementalBatchRatio < liveTasks.size())
+        {
+            std::size_t added = 0;
+            for (const auto &edge : edges)
+            {
+                GraphNode *node = findNode(edge.first);
+                GraphNode *dep = findNode(edge.second);
+                if (node && dep && insertEdge(node, dep))
+                {
+                    if (journal)
+                        journal->logDependency(edge.first, edge.second);
+                    ++added;
+                }
+            }
+            return added;
+        }
+
+        std::vector<std::pair<GraphNode *, GraphNode *>> resolved;
+        resolved.reserve(edges.size());
+        for (const auto &edge : edges)
+        {
+            GraphNode *node = findNode(edge.first);
+            GraphNode *dep = findNode(edge.second);
+            if (node && dep && node != dep)
+                resolved.emplace_back(node, dep);
+        }
+
+        // Re-analysed on the next query rather than edge by edge
+        scheduleValid = false;
+        ++graphEdits;
+        for (auto &edge : resolved)
+        {
+            edge.first->dependencies.push_back(edge.second);
+            edge.second->dependents.push_back(edge.first);
+        }
+
+        if (!rebuildTopoOrder())
+        {
+            for (auto it = resolved.rbegin(); it != resolved.rend(); ++it)
+            {
+                it->first->dependencies.pop_back();
+                it->second->dependents.pop_back();
+            }
+            std::size_t added = 0;
+            for (auto &edge : resolved)
+            {
+                if (insertEdge(edge.first, edge.second))
+                {
+                    if (journal)
+                        journal->logDependency(edge.first->task->getName(), edge.second->task->getName());
+                    ++added;
+                }
+            }
+            return added;
+        }
+
+        // Count the new blockers, then rebuild the ready queue once
+        for (auto &edge : resolved)
+        {
+            if (!edge.first->completed && !edge.second->completed)
+                ++edge.first->pendingDependencies;
+            markChanged(edge.first->id);
+            if (journal)
+                journal->logDependency(edge.first->task->getName(), edge.second->task->getName());
+        }
+        readyQueue.clear();
+        for (TaskId id : liveTasks)
+        {
+            GraphNode *node = nodeArena.at(id);
+            if (!node->completed && node->pendingDependencies == 0)
+                readyQueue.pushUnordered(node);
+        }
+        readyQueue.rebuild();
+        return resolved.size();
+    }
+
+    // Apply a batch all-or-nothing. Every operation is first checked against
+    // the state the earlier ones leave behind, and the final graph is
+    // checked for cycles; on any failure nothing changes and error, if
+    // given, says why. The changes are then applied with one heap fix-up
+    // and one topological-order update for the whole batch, so the cost is
+    // O(batch + affected) rather than a full pass per operation. Large
+    // batches rebuild both heaps with a single heapify instead.
+    bool applyBatch(const TaskBatch &batch, std::string *error = nullptr)
+    {
+        OpTimer timer(opStats, StatOp::BATCH);
+        const std::vector<BatchOp> &ops = batch.operations();
+
+        auto reject = [&](const std::string &reason)
+        {
+            TM_LOG(WARN, "Batch rejected: " << reason);
+            if (error)
+                *error = reason;
+            return false;
+        };
+
+        // Names the batch has added or deleted so far, over taskIndex
+        std::unordered_map<std::string_view, BatchRef> names;
+        auto lookup = [&](const std::string &name)
+        {
+            auto it = names.find(name);
+            if (it != names.end())
+                return it->second;
+            TaskId id = taskIndex.find(name);
+            return id == kInvalidTaskId ? kBatchMissing : BatchRef(id);
+        };
+
+        const unsigned deletedMark = nextVisitEpoch();
+        std::vector<bool> addedAlive;
+        std::vector<std::pair<BatchRef, BatchRef>> edges; // (task, dependency)
+        for (std::size_t i = 0; i < ops.size(); ++i)
+        {
+            const BatchOp &op = ops[i];
+            const std::string where = "operation " + std::to_string(i + 1) + ": ";
+            BatchRef ref = lookup(op.task.name);
+            switch (op.kind)
+            {
+            case BatchOpKind::ADD_TASK:
+                if (ref != kBatchMissing)
+                    return reject(where + "task '" + op.task.name + "' already exists");
+                names[op.task.name] = kBatchAdded + addedAlive.size();
+                addedAlive.push_back(true);
+                break;
+            case BatchOpKind::DELETE_TASK:
+            case BatchOpKind::SET_STATUS:
+                if (ref == kBatchMissing)
+                    return reject(where + "task '" + op.task.name + "' not found");
+                if (op.kind == BatchOpKind::SET_STATUS)
+                    break;
+                if (ref & kBatchAdded)
+                    addedAlive[ref - kBatchAdded] = false;
+                else
+                    nodeArena.at(static_cast<TaskId>(ref))->visitMark = deletedMark;
+                names[op.task.name] = kBatchMissing;
+                break;
+            case BatchOpKind::ADD_DEPENDENCY:
+            {
+                BatchRef dep = lookup(op.dependency);
+                if (ref == kBatchMissing || dep == kBatchMissing)
+                    return reject(where + "task '" + (ref == kBatchMissing ? op.task.name : op.dependency) + "' not found");
+                if (ref == dep)
+                    return reject(where + "task '" + op.task.name + "' cannot depend on itself");
+                edges.emplace_back(ref, dep);
+                break;
+            }
+            }
+        }
+
+        std::vector<BatchRef> order;
+        if (!orderBatchWindows(edges, addedAlive, deletedMark, order))
+            return reject("the dependencies would create a cycle");
+
+        // Nothing below can fail
+        const bool heapify = ops.size() * kIncrementalBatchRatio >= liveTasks.size();
+        if (heapify)
+        {
+            reserveTasks(addedAlive.size());
+            taskQueue.clear();
+            readyQueue.clear();
+        }
+        scheduleValid = false; // Re-analysed on the next query rather than per operation
+
+        std::vector<TaskId> created;
+        created.reserve(addedAlive.size());
+        for (const BatchOp &op : ops)
+        {
+            switch (op.kind)
+            {
+            case BatchOpKind::ADD_TASK:
+            {
+                const TaskRecord &record = op.task;
+                TaskId id = createTask(record.name, record.description, record.deadline, record.completion, record.duration);
+                created.push_back(id);
+                if (!heapify)
+                {
+                    taskQueue.push(taskArena.at(id));
+                    readyQueue.push(nodeArena.at(id));
+                }
+                if (journal)
+                {
+                    journal->logAddTask(record.name, record.description, record.deadline, record.completion);
+                    if (record.duration != kDefaultDuration)
+                        journal->logDuration(record.name, record.duration);
+                }
+                break;
+            }
+            case BatchOpKind::DELETE_TASK:
+                if (journal)
+                    journal->logDeleteTask(op.task.name);
+                removeTask(taskIndex.find(op.task.name));
+                break;
+            case BatchOpKind::ADD_DEPENDENCY:
+                linkNodes(findNode(op.task.name), findNode(op.dependency));
+                if (journal)
+                    journal->logDependency(op.task.name, op.dependency);
+                break;
+            case BatchOpKind::SET_STATUS:
+                markTaskCompleted(taskArena.at(taskIndex.find(op.task.name)), op.status);
+                break;
+            }
+        }
+
+        // Deletes only leave holes and adds append, so each window's tasks
+        // still hold its slots in the same relative order; deal them out
+        // again in the order computed up front
+        if (!order.empty())
+        {
+            std::vector<GraphNode *> nodes;
+            std::vector<std::size_t> slots;
+            nodes.reserve(order.size());
+            slots.reserve(order.size());
+            for (BatchRef ref : order)
+            {
+                GraphNode *node = nodeArena.at(ref & kBatchAdded ? created[ref - kBatchAdded] : static_cast<TaskId>(ref));
+                nodes.push_back(node);
+                slots.push_back(node->topoIndex);
+            }
+            std::sort(slots.begin(), slots.end());
+            for (std::size_t i = 0; i < nodes.size(); ++i)
+            {
+                nodes[i]->topoIndex = slots[i];
+                topoOrder[slots[i]] = nodes[i];
+            }
+        }
+
+        if (heapify)
+        {
+            readyQueue.clear(); // Holds whatever deletes and completions released
+            for (TaskId id : liveTasks)
+            {
+                taskQueue.pushUnordered(taskArena.at(id));
+                GraphNode *node = nodeArena.at(id);
+                if (!node->completed && node->pendingDependencies == 0)
+                    readyQueue.pushUnordered(node);
+            }
+            taskQueue.rebuild();
+            readyQueue.rebuild();
+        }
+        return true;
+    }
+
+    // Look up a task by name; nullptr if it does not exist
+    Task *findTask(std::string_view name) const
+    {
+        OpTimer timer(opStats, StatOp::LOOKUP);
+        TaskId id = taskIndex.find(name);
+        return id == kInvalidTaskId ? nullptr : taskArena.at(id);
+    }
+
+    TaskHandle handleOf(std::string_view name) const
+    {
+        TaskId id = taskIndex.find(name);
+        return id == kInvalidTaskId ? TaskHandle() : TaskHandle{id, generations[id]};
+    }
+
+    // Resolve a handle; nullptr if the task it referred to has been deleted
+    Task *resolve(TaskHandle handle) const
+    {
+        if (handle.id >= generations.size() || generations[handle.id] != handle.generation)
+            return nullptr;
+        return taskArena.at(handle.id);
+    }
+
+    std::size_t taskCount() const
+    {
+        return liveTasks.size();
+    }
+
+    bool deleteTask(const std::string &taskName)
+    {
+        OpTimer timer(opStats, StatOp::DELETE_TASK);
+        TaskId id = taskIndex.find(taskName);
+        if (id == kInvalidTaskId)
+        {
+            TM_LOG(WARN, "Task '" << taskName << "' not found.");
+            return false;
+        }
+
+        if (journal)
+            journal->logDeleteTask(taskName);
+        removeTask(id);
+
+        TM_LOG(DEBUG, "Task '" << taskName << "' deleted.");
+        return true;
+    }
+
+    // Method to prompt user for task name and delete the task if found
+    void deleteTaskPrompt()
+    {
+        std::string taskNameToDelete;
+        std::cout << "Enter the name of the task to delete: ";
+        std::getline(std::cin, taskNameToDelete); // The menu already consumed the previous newline
+
+        if (deleteTask(taskNameToDelete))
+            std::cout << "Task '" << taskNameToDelete << "' deleted successfully." << std::endl;
+    }
+
+    // Method to add dependencies between tasks
+    // Edges that would create a cycle are rejected and leave the graph unchanged
+    bool addDependency(const std::string &taskName, const std::string &dependencyName)
+    {
+        OpTimer timer(opStats, StatOp::ADD_DEPENDENCY);
+        GraphNode *node = findNode(taskName);
+        GraphNode *dep = findNode(dependencyName);
+        if (node && dep)
+        {
+            if (!insertEdge(node, dep))
+            {
+                TM_LOG(WARN, "Dependency rejected: '" << taskName << "' -> '" << dependencyName << "' would create a cycle.");
+                return false;
+            }
+
+            if (journal)
+                journal->logDependency(taskName, dependencyName);
+            TM_LOG(DEBUG, "Dependency added: '" << taskName << "' -> '" << dependencyName << "'.");
+            return true;
+        }
+        else
+        {
+            TM_LOG(WARN, "Task or dependency not found. Please make sure both tasks exist.");
+            return false;
+        }
+    }
+
+    // Method to mark task as completed
+    void markTaskCompleted(Task *task, CompletionStatus status)
+    {
+        OpTimer timer(opStats, StatOp::SET_STATUS);
+        task->setStatus(status);
+        task->priority = Policy::score(*task);
+        markChanged(task->getId());
+        if (journal)
+            journal->logStatus(task->getName(), status);
+        columns.completion[task->getId()] = task->completionFactor;
+        taskQueue.update(task); // Re-key in place with the new priority
+
+        GraphNode *node = nodeArena.at(task->getId());
+        readyQueue.update(node);
+        if (status == CompletionStatus::FINISHED)
+            completeNode(node);
+        updateSchedule(node);
+    }
+
+    // Most urgent task whose dependencies have all finished; nullptr if none
+    Task *nextReadyTask() const
+    {
+        return readyQueue.empty() ? nullptr : readyQueue.top()->task;
+    }
+
+    // Execute ready tasks in priority order until every remaining task is
+    // blocked on an unfinished dependency. Each completion costs
+    // O(out-degree + log n) and taskQueue is left intact.
+    std::size_t runReadyTasks()
+    {
+        scheduleValid = false; // Cheaper to re-analyse once than after every completion
+        std::size_t executed = 0;
+        while (!readyQueue.empty())
+        {
+            OpTimer timer(opStats, StatOp::DISPATCH);
+            GraphNode *node = readyQueue.top();
+            TM_LOG(INFO, "Executing task: " << node->task->getName());
+            markTaskCompleted(node->task, CompletionStatus::FINISHED);
+            ++executed;
+        }
+
+        std::size_t blocked = liveTasks.size() - completedCount;
+        if (blocked > 0)
+            TM_LOG(INFO, blocked << " task(s) waiting on unfinished dependencies.");
+        return executed;
+    }
+
+    // Execute every runnable task on a work-stealing thread pool. Each node
+    // gets an atomic in-degree counter; a worker that finishes a task
+    // releases its dependents onto its own deque, sorted so the most urgent
+    // one is popped next, and idle workers steal from the other end or
+    // park until more tasks are released.
+    ParallelRunStats executeTasksParallel(unsigned workerCount, const std::function<void(Task &)> &work = {})
+    {
+        ParallelRunStats stats;
+        stats.workers = std::max(1u, workerCount);
+        scheduleValid = false; // Cheaper to re-analyse once than after every completion
+
+        std::vector<GraphNode *> nodes;
+        nodes.reserve(liveTasks.size() - completedCount);
+        for (TaskId id : liveTasks)
+        {
+            GraphNode *node = nodeArena.at(id);
+            if (!node->completed)
+                nodes.push_back(node);
+        }
+
+        // Counters are indexed directly by TaskId
+        std::unique_ptr<std::atomic<int>[]> pending(new std::atomic<int>[generations.size()]);
+        std::vector<GraphNode *> initial;
+        for (GraphNode *node : nodes)
+        {
+            pending[node->id].store(node->pendingDependencies, std::memory_order_relaxed);
+            if (node->pendingDependencies == 0)
+                initial.push_back(node);
+        }
+
+        // Deal the initial ready set round-robin, most urgent first, so each
+        // deque ends with its most urgent task at the back
+        std::vector<std::unique_ptr<WorkStealingDeque>> deques;
+        for (unsigned w = 0; w < stats.workers; ++w)
+            deques.emplace_back(new WorkStealingDeque());
+        std::sort(initial.begin(), initial.end(), [](GraphNode *a, GraphNode *b)
+                  { return CompareNode<Policy>()(b, a); });
+        for (std::size_t i = initial.size(); i-- > 0;)
+            deques[i % stats.workers]->pushBack(initial[i]);
+
+        std::atomic<std::size_t> outstanding(initial.size()); // Queued or running tasks
+        std::atomic<std::size_t> queued(initial.size());      // Sitting in a deque
+        std::atomic<std::size_t> finished(0);
+        std::atomic<std::size_t> steals(0);
+        std::vector<GraphNode *> finishOrder(nodes.size());
+        std::vector<double> busyMs(stats.workers, 0.0);
+
+        // Idle workers park here instead of spinning. A waker bumps its
+        // counter before reading idle and a sleeper bumps idle before
+        // re-checking the counters, all seq_cst, so no wakeup is lost.
+        std::mutex parkLock;
+        std::condition_variable parked;
+        std::atomic<unsigned> idle(0);
+        auto wake = [&](std::size_t count)
+        {
+            if (count == 0 || idle.load() == 0)
+                return;
+            std::lock_guard<std::mutex> guard(parkLock);
+            if (count >= stats.workers)
+                parked.notify_all();
+            else
+                while (count-- > 0)
+                    parked.notify_one();
+        };
+
+        auto worker = [&](unsigned self)
+        {
+            std::vector<GraphNode *> released;
+            std::size_t victim = self;
+            unsigned misses = 0;
+            while (outstanding.load() > 0)
+            {
+                GraphNode *node = nullptr;
+                if (!deques[self]->popBack(node))
+                {
+                    for (unsigned attempt = 1; attempt < stats.workers && !node; ++attempt)
+                    {
+                        victim = (victim + 1) % stats.workers;
+                        if (victim != self && deques[victim]->stealFront(node))
+                            steals.fetch_add(1, std::memory_order_relaxed);
+                    }
+                }
+                if (!node)
+                {
+                    // A few retries cover a task that is about to be pushed
+                    if (++misses < 16)
+                    {
+                        std::this_thread::yield();
+                        continue;
+                    }
+                    misses = 0;
+                    idle.fetch_add(1);
+                    {
+                        std::unique_lock<std::mutex> guard(parkLock);
+                        parked.wait(guard, [&]
+                                    { return queued.load() > 0 || outstanding.load() == 0; });
+                    }
+                    idle.fetch_sub(1);
+                    continue;
+                }
+                misses = 0;
+                queued.fetch_sub(1);
+
+                auto begin = std::chrono::steady_clock::now();
+                if (work)
+                    work(*node->task);
+                finishOrder[finished.fetch_add(1, std::memory_order_acq_rel)] = node;
+
+                released.clear();
+                for (GraphNode *dependent : node->dependents)
+                {
+                    if (!dependent->completed && pending[dependent->id].fetch_sub(1, std::memory_order_acq_rel) == 1)
+                        released.push_back(dependent);
+                }
+                std::sort(released.begin(), released.end(), CompareNode<Policy>());
+                outstanding.fetch_add(released.size());
+                queued.fetch_add(released.size());
+                for (GraphNode *next : released)
+                    deques[self]->pushBack(next);
+                // This worker takes one of them itself; the last task out
+                // releases everyone still parked
+                if (outstanding.fetch_sub(1) == 1)
+                    wake(stats.workers);
+                else if (released.size() > 1)
+                    wake(released.size() - 1);
+
+                busyMs[self] += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count();
+            }
+        };
+
+        auto start = std::chrono::steady_clock::now();
+        std::vector<std::thread> threads;
+        for (unsigned w = 1; w < stats.workers; ++w)
+            threads.emplace_back(worker, w);
+        worker(0);
+        for (auto &thread : threads)
+            thread.join();
+        stats.makespanMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+        // finishOrder respects dependencies, so the serial bookkeeping can
+        // replay it directly
+        stats.executed = finished.load();
+        for (std::size_t i = 0; i < stats.executed; ++i)
+            markTaskCompleted(finishOrder[i]->task, CompletionStatus::FINISHED);
+
+        double busyTotal = 0.0;
+        for (double ms : busyMs)
+            busyTotal += ms;
+        if (stats.makespanMs > 0.0)
+            stats.utilization = busyTotal / (stats.workers * stats.makespanMs);
+        stats.steals = steals.load();
+        return stats;
+    }
+
+#ifdef TM_HAS_COROUTINES
+    // Attach an executable body to a task. It runs on the next
+    // executeTasksAsync and is expected to co_await context.dependencies()
+    // before touching their results.
+    bool setTaskBody(const std::string &taskName, TaskBody body)
+    {
+        TaskId id = taskIndex.find(taskName);
+        if (id == kInvalidTaskId)
+        {
+            TM_LOG(ERROR, "Task '" << taskName << "' not found.");
+            return false;
+        }
+        if (bodies.size() <= id)
+            bodies.resize(id + 1);
+        bodies[id] = std::move(body);
+        return true;
+    }
+
+    // Run the body of every unfinished task as a coroutine on workerCount
+    // threads. All bodies start at once and suspend on what they await, so
+    // a task blocked on a dependency, a timer or I/O holds no thread. A
+    // task without a body just waits for its dependencies. Completions are
+    // applied afterwards in the order the bodies returned.
+    AsyncRunStats executeTasksAsync(unsigned workerCount)
+    {
+        AsyncRunStats stats;
+        stats.workers = std::max(1u, workerCount);
+        scheduleValid = false; // Cheaper to re-analyse once than after every completion
+
+        CoroutineExecutor executor(generations.size(), liveTasks.size() - completedCount);
+        auto waitForDependencies = [](TaskContext context) -> AsyncTask
+        {
+            co_await context.dependencies();
+        };
+        for (TaskId id : liveTasks)
+        {
+            GraphNode *node = nodeArena.at(id);
+            if (node->completed)
+            {
+                executor.markFinished(id);
+                continue;
+            }
+            TaskContext context(&executor, node->task, node);
+            if (id < bodies.size() && bodies[id])
+                executor.spawn(bodies[id](context), id);
+            else
+                executor.spawn(waitForDependencies(context), id);
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        executor.run(stats.workers);
+        stats.makespanMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+        for (const auto &failure : executor.failedTasks())
+        {
+            try
+            {
+                std::rethrow_exception(failure.second);
+            }
+            catch (const std::exception &error)
+            {
+                TM_LOG(ERROR, "Task '" << taskArena.at(failure.first)->getName() << "' failed: " << error.what());
+            }
+            catch (...)
+            {
+                TM_LOG(ERROR, "Task '" << taskArena.at(failure.first)->getName() << "' failed.");
+            }
+        }
+        stats.failed = executor.failedTasks().size();
+
+        stats.executed = executor.finishedCount();
+        for (std::size_t i = 0; i < stats.executed; ++i)
+            markTaskCompleted(taskArena.at(executor.finishedAt(i)), CompletionStatus::FINISHED);
+        return stats;
+    }
+#endif
+
+    // Re-score every task against the current clock in one batch: the
+    // columnar kernel recomputes all priorities, the results are written
+    // back to the tasks, each heap is rebuilt with a single heapify and
+    // every band change is rescheduled
+    void rescoreAllTasks()
+    {
+        OpTimer timer(opStats, StatOp::RESCORE);
+        rescoreColumns<Policy>(columns, static_cast<float>(currentTime));
+        for (TaskId id : liveTasks)
+        {
+            Task *task = taskArena.at(id);
+            task->deadlineFactor = columns.deadlineFactor[id];
+            if constexpr (Policy::linear)
+                task->priority = columns.priority[id];
+            else
+                task->priority = Policy::score(*task);
+            markChanged(id);
+        }
+        taskQueue.rebuild();
+        readyQueue.rebuild();
+        rebuildAgingQueue();
+    }
+
+    // Move the clock forward by hand; deadlines get closer, so priorities
+    // age. On a real clock this shifts it for good.
+    void advanceClock(int ticks)
+    {
+        clockStartTime += ticks;
+        moveClock(ticks);
+    }
+
+    // Drive the clock from wall time, one unit per unit of real time,
+    // starting at the current clock value. A zero unit makes it manual again.
+    void setRealClock(std::chrono::milliseconds unit)
+    {
+        clockUnit = unit;
+        clockStart = std::chrono::steady_clock::now();
+        clockStartTime = currentTime;
+    }
+
+    bool realClock() const
+    {
+        return clockUnit.count() > 0;
+    }
+
+    // Catch a real clock up with wall time
+    void syncClock()
+    {
+        if (!realClock())
+            return;
+        auto units = (std::chrono::steady_clock::now() - clockStart) / clockUnit;
+        int target = clockStartTime + static_cast<int>(units);
+        if (target > currentTime)
+            moveClock(target - currentTime);
+    }
+
+    // React to deadline events, e.g. by boosting the task; tasks are
+    // flagged either way. The handler runs on the thread that moves the
+    // clock or adds the task, and must not add or delete tasks.
+    void setDeadlineHandler(std::function<void(Task &, DeadlineEvent)> handler)
+    {
+        deadlineHandler = std::move(handler);
+    }
+
+    int getCurrentTime() const
+    {
+        return currentTime;
+    }
+
+    // Fold every change since the last call into a new TaskVersion and
+    // make it the one currentVersion returns. Costs a few path copies per
+    // changed task; the first call copies every task and turns change
+    // tracking on. Runs on the thread that mutates the manager.
+    void publishVersion()
+    {
+        if (!versioning)
+        {
+            versioning = true;
+            for (TaskId id : liveTasks)
+                markChanged(id);
+        }
+
+        ++versionEdit; // Everything published before is shared from now on
+        for (TaskId id : changedTasks)
+        {
+            TaskChange change = static_cast<TaskChange>(taskChange[id]);
+            taskChange[id] = UNCHANGED;
+            std::shared_ptr<const TaskView> view = change == REMOVED ? nullptr : makeTaskView(id);
+            const TaskView *previous = versionTasks.find(id);
+            if (previous && (!view || previous->name != view->name))
+                updateVersionName(previous->name, id, false);
+            if (view && (!previous || previous->name != view->name))
+                updateVersionName(view->name, id, true);
+            versionTasks.assign(id, std::move(view), versionEdit);
+        }
+        changedTasks.clear();
+
+        auto version = std::make_shared<const TaskVersion>(versionTasks, versionNames, ++versionNumber, currentTime);
+        std::lock_guard<std::mutex> lock(versionLock);
+        publishedVersion = std::move(version);
+    }
+
+    // Latest published version in O(1), or nullptr before the first
+    // publishVersion. Safe to call from any thread; the version stays
+    // valid and unchanged for as long as the caller holds it.
+    std::shared_ptr<const TaskVersion> currentVersion() const
+    {
+        std::lock_guard<std::mutex> lock(versionLock);
+        return publishedVersion;
+    }
+
+    // Change the estimated duration of a task; the schedule analysis is
+    // updated incrementally from that task
+    bool setTaskDuration(const std::string &taskName, int duration)
+    {
+        Task *task = findTask(taskName);
+        if (!task || duration < 0)
+            return false;
+        task->duration = duration;
+        if (journal)
+            journal->logDuration(taskName, duration);
+        rescoreTask(task); // Policies may weigh job size
+        updateSchedule(nodeArena.at(task->getId()));
+        return true;
+    }
+
+    // Full critical-path analysis: earliest start/finish in a forward pass,
+    // latest start/finish in a backward pass. Nodes are grouped by level
+    // (longest dependency chain below them); a level only reads results of
+    // earlier levels, so each one is processed in parallel. Afterwards
+    // every change updates the results incrementally until something
+    // invalidates them wholesale (clock advance, bulk edges, execution).
+    void analyzeSchedule()
+    {
+        OpTimer timer(opStats, StatOp::ANALYZE);
+        // topoOrder lists dependencies first, so one pass assigns every
+        // level; a counting sort then lays the nodes out level by level
+        std::vector<std::uint32_t> level(generations.size(), 0);
+        std::vector<std::size_t> levelStart(1, 0);
+        for (GraphNode *node : topoOrder)
+        {
+            if (!node)
+                continue;
+            std::uint32_t l = 0;
+            for (GraphNode *dep : node->dependencies)
+                l = std::max(l, level[dep->id] + 1);
+            level[node->id] = l;
+            if (levelStart.size() < l + 2)
+                levelStart.resize(l + 2, 0);
+            ++levelStart[l + 1];
+        }
+        for (std::size_t l = 1; l < levelStart.size(); ++l)
+            levelStart[l] += levelStart[l - 1];
+        std::vector<GraphNode *> byLevel(liveTasks.size());
+        std::vector<std::size_t> fill(levelStart.begin(), levelStart.end() - 1);
+        for (GraphNode *node : topoOrder)
+        {
+            if (node)
+                byLevel[fill[level[node->id]]++] = node;
+        }
+
+        unsigned workers = parallelWorkers > 1 ? parallelWorkers : std::max(1u, std::thread::hardware_concurrency());
+        const std::size_t levels = levelStart.size() - 1;
+        for (std::size_t l = 0; l < levels; ++l)
+            forEachNode(byLevel.data() + levelStart[l], levelStart[l + 1] - levelStart[l], workers, [this](GraphNode *node)
+                        { computeEarliest(node); });
+        for (std::size_t l = levels; l-- > 0;)
+            forEachNode(byLevel.data() + levelStart[l], levelStart[l + 1] - levelStart[l], workers, [](GraphNode *node)
+                        { computeLatest(node); });
+        scheduleValid = true;
+    }
+
+    ScheduleInfo scheduleOf(const Task *task)
+    {
+        if (!scheduleValid)
+            analyzeSchedule();
+        const GraphNode *node = nodeArena.at(task->getId());
+        return ScheduleInfo{node->earliestStart, node->earliestFinish, node->latestStart, node->latestFinish, slackOf(node)};
+    }
+
+    // The chain of unfinished tasks with the least slack, first task first:
+    // from the least-slack task that finishes last, walk back through the
+    // dependency that fixes each earliest start
+    std::vector<Task *> criticalPath()
+    {
+        std::vector<Task *> path;
+        if (!scheduleValid)
+            analyzeSchedule();
+        GraphNode *last = nullptr;
+        for (TaskId id : liveTasks)
+        {
+            GraphNode *node = nodeArena.at(id);
+            if (node->completed)
+                continue;
+            if (!last || slackOf(node) < slackOf(last) || (slackOf(node) == slackOf(last) && node->earliestFinish > last->earliestFinish))
+                last = node;
+        }
+        for (GraphNode *node = last; node;)
+        {
+            path.push_back(node->task);
+            GraphNode *binding = nullptr;
+            for (GraphNode *dep : node->dependencies)
+            {
+                if (!dep->completed && dep->earliestFinish == node->earliestStart && (!binding || slackOf(dep) < slackOf(binding)))
+                    binding = dep;
+            }
+            node = binding;
+        }
+        std::reverse(path.begin(), path.end());
+        return path;
+    }
+
+    // Unfinished tasks with negative slack, most negative first, at most
+    // limit of them; total receives how many there are in all
+    std::vector<Task *> threatenedTasks(std::size_t limit, std::size_t *total = nullptr)
+    {
+        if (!scheduleValid)
+            analyzeSchedule();
+        std::vector<TaskId> late;
+        for (TaskId id : liveTasks)
+        {
+            const GraphNode *node = nodeArena.at(id);
+            if (!node->completed && slackOf(node) < 0)
+                late.push_back(id);
+        }
+        if (total)
+            *total = late.size();
+
+        std::size_t keep = std::min(limit, late.size());
+        std::partial_sort(late.begin(), late.begin() + keep, late.end(), [this](TaskId a, TaskId b)
+                          {
+            std::int64_t sa = slackOf(nodeArena.at(a));
+            std::int64_t sb = slackOf(nodeArena.at(b));
+            return sa < sb || (sa == sb && a < b); });
+        std::vector<Task *> result;
+        result.reserve(keep);
+        for (std::size_t i = 0; i < keep; ++i)
+            result.push_back(taskArena.at(late[i]));
+        return result;
+    }
+
+    // Print the critical path and the tasks that threaten deadlines
+    void displayCriticalPath()
+    {
+        std::vector<Task *> path = criticalPath();
+        std::size_t lateCount = 0;
+        std::vector<Task *> late = threatenedTasks(10, &lateCount);
+
+        OutputBuffer out;
+        if (path.empty())
+            out << "No unfinished tasks.\n";
+        else
+        {
+            ScheduleInfo end = scheduleOf(path.back());
+            out << "Critical path (" << path.size() << " task(s), earliest finish " << static_cast<long long>(end.earliestFinish)
+                << ", slack " << static_cast<long long>(end.slack) << "):\n";
+            for (Task *task : path)
+            {
+                ScheduleInfo info = scheduleOf(task);
+                out << "  " << task->getName() << ": start " << static_cast<long long>(info.earliestStart) << ", finish "
+                    << static_cast<long long>(info.earliestFinish) << ", duration " << task->getDuration() << '\n';
+            }
+        }
+        out << lateCount << " task(s) threaten a deadline.\n";
+        for (Task *task : late)
+        {
+            ScheduleInfo info = scheduleOf(task);
+            out << "  " << task->getName() << ": slack " << static_cast<long long>(info.slack) << ", deadline " << task->getDeadline()
+                << ", earliest finish " << static_cast<long long>(info.earliestFinish) << '\n';
+        }
+        out.flush();
+    }
+
+    // Latency histograms for every instrumented operation
+    const TaskManagerStats &statistics() const
+    {
+        return opStats;
+    }
+
+    // Estimated bytes held by the task store, graph, queues and indexes.
+    // Short names that fit the string's inline buffer cost nothing extra.
+    std::size_t memoryUsage() const
+    {
+        auto stringBytes = [](const std::string &text)
+        {
+            return text.capacity() > std::string().capacity() ? text.capacity() + 1 : 0;
+        };
+        std::size_t bytes = taskArena.capacity() * sizeof(Task) + nodeArena.capacity() * sizeof(GraphNode);
+        for (TaskId id : liveTasks)
+        {
+            const Task *task = taskArena.at(id);
+            const GraphNode *node = nodeArena.at(id);
+            bytes += stringBytes(task->name) + stringBytes(task->description);
+            bytes += (node->dependencies.capacity() + node->dependents.capacity()) * sizeof(GraphNode *);
+        }
+        bytes += generations.capacity() * sizeof(std::uint32_t) + freeIds.capacity() * sizeof(TaskId) + liveTasks.capacity() * sizeof(TaskId);
+        bytes += taskQueue.capacity() * sizeof(Task *) + readyQueue.capacity() * sizeof(GraphNode *) + topoOrder.capacity() * sizeof(GraphNode *);
+        bytes += taskIndex.memoryBytes();
+        bytes += rekeyAt.capacity() * sizeof(int) + agingQueue.capacity() * sizeof(agingQueue[0]);
+        bytes += deadlineWheel.memoryBytes() + frozen.memoryBytes();
+        bytes += (columns.deadline.capacity() + columns.completion.capacity() + columns.deadlineFactor.capacity() + columns.priority.capacity()) * sizeof(float);
+        return bytes;
+    }
+
+    // Print queue depths, graph size, memory use and per-operation latency
+    void displayStats()
+    {
+        std::size_t edges = 0;
+        for (TaskId id : liveTasks)
+            edges += nodeArena.at(id)->dependencies.size();
+
+        OutputBuffer out;
+        out << "Tasks: " << liveTasks.size() << " live, " << completedCount << " executed, " << readyQueue.size() << " ready, "
+            << taskQueue.size() << " queued\n";
+        out << "Graph: " << edges << " dependencies, " << topoHoles << " free topological slot(s)\n";
+        out << "Clock: " << currentTime << (realClock() ? " (real time), " : ", ") << agingQueue.size() << " pending band change(s)\n";
+        out << "Deadlines: " << deadlineWheel.size() << " timer(s) armed, " << deadlineEvents[0] << " approaching and "
+            << deadlineEvents[1] << " overdue event(s) fired\n";
+        if (journal)
+            out << "Journal: " << journal->size() << " bytes, sequence " << appliedSequence << '\n';
+        out << "Memory: " << memoryUsage() / 1024 << " KiB estimated, " << residentBytes() / 1024 << " KiB resident\n";
+        out << "Latency per operation (ns):\n";
+        for (int op = 0; op < static_cast<int>(StatOp::COUNT); ++op)
+        {
+            const LatencyHistogram &histogram = opStats.ops[op];
+            if (histogram.count() == 0)
+                continue;
+            out << "  " << statOpName(static_cast<StatOp>(op)) << ": count " << histogram.count() << ", mean "
+                << static_cast<long long>(histogram.meanNs()) << ", p50 " << histogram.percentile(0.5) << ", p99 "
+                << histogram.percentile(0.99) << ", p99.9 " << histogram.percentile(0.999) << ", max " << histogram.max() << '\n';
+        }
+        out.flush();
+    }
+
+    // Write all tasks and the dependency graph to a versioned binary
+    // snapshot. The data goes to PATH.tmp, is fsynced and then renamed over
+    // PATH, so a crash leaves either the old or the new snapshot intact.
+    bool saveSnapshot(const std::string &path) const
+    {
+        OpTimer timer(opStats, StatOp::SNAPSHOT);
+        // Tasks are stored in topological order so every edge points backwards
+        std::vector<std::uint32_t> snapIndex(generations.size());
+        std::vector<SnapshotTask> records;
+        std::vector<std::uint64_t> offsets;
+        std::vector<std::uint32_t> edges;
+        std::string strings;
+        records.reserve(liveTasks.size());
+        offsets.reserve(liveTasks.size() + 1);
+        offsets.push_back(0);
+
+        for (GraphNode *node : topoOrder)
+        {
+            if (!node)
+                continue;
+            const Task *task = node->task;
+            snapIndex[node->id] = static_cast<std::uint32_t>(records.size());
+
+            SnapshotTask record = {};
+            record.nameOffset = strings.size();
+            record.nameLength = static_cast<std::uint32_t>(task->name.size());
+            strings += task->name;
+            record.descriptionOffset = strings.size();
+            record.descriptionLength = static_cast<std::uint32_t>(task->description.size());
+            strings += task->description;
+            record.deadline = task->deadline;
+            record.completion = task->completionFactor;
+            record.status = static_cast<std::uint8_t>(task->status);
+            record.completed = node->completed ? 1 : 0;
+            record.duration = task->duration;
+            records.push_back(record);
+
+            for (GraphNode *dep : node->dependencies)
+                edges.push_back(snapIndex[dep->id]);
+            offsets.push_back(edges.size());
+        }
+
+        auto aligned = [](std::uint64_t size)
+        { return (size + 7) & ~std::uint64_t(7); };
+
+        SnapshotHeader header = {};
+        std::memcpy(header.magic, kSnapshotMagic, sizeof(header.magic));
+        header.version = kSnapshotVersion;
+        header.headerSize = sizeof(SnapshotHeader);
+        header.taskCount = records.size();
+        header.edgeCount = edges.size();
+        header.stringBytes = strings.size();
+        header.currentTime = currentTime;
+        header.tasksOffset = aligned(sizeof(SnapshotHeader));
+        header.offsetsOffset = header.tasksOffset + aligned(records.size() * sizeof(SnapshotTask));
+        header.edgesOffset = header.offsetsOffset + aligned(offsets.size() * sizeof(std::uint64_t));
+        header.stringsOffset = header.edgesOffset + aligned(edges.size() * sizeof(std::uint32_t));
+        header.fileSize = header.stringsOffset + strings.size();
+        header.journalSequence = journal ? journal->lastSequence() : appliedSequence;
+
+        std::string tmpPath = path + ".tmp";
+        std::FILE *out = std::fopen(tmpPath.c_str(), "wb");
+        if (!out)
+            return false;
+
+        // Header first with a zero checksum; it is rewritten at the end
+        bool ok = std::fwrite(&header, sizeof(header), 1, out) == 1;
+        std::uint64_t checksum = fnv1a(nullptr, 0);
+        std::uint64_t written = sizeof(header);
+        auto writeSection = [&](std::uint64_t offset, const void *data, std::size_t size)
+        {
+            static const char padding[8] = {};
+            std::size_t gap = static_cast<std::size_t>(offset - written);
+            checksum = fnv1a(padding, gap, checksum);
+            checksum = fnv1a(data, size, checksum);
+            ok = ok && std::fwrite(padding, 1, gap, out) == gap && (size == 0 || std::fwrite(data, 1, size, out) == size);
+            written = offset + size;
+        };
+        writeSection(header.tasksOffset, records.data(), records.size() * sizeof(SnapshotTask));
+        writeSection(header.offsetsOffset, offsets.data(), offsets.size() * sizeof(std::uint64_t));
+        writeSection(header.edgesOffset, edges.data(), edges.size() * sizeof(std::uint32_t));
+        writeSection(header.stringsOffset, strings.data(), strings.size());
+
+        header.checksum = checksum;
+        ok = ok && std::fseek(out, 0, SEEK_SET) == 0 && std::fwrite(&header, sizeof(header), 1, out) == 1;
+        ok = ok && std::fflush(out) == 0 && fsync(fileno(out)) == 0;
+        ok = std::fclose(out) == 0 && ok;
+        if (!ok || std::rename(tmpPath.c_str(), path.c_str()) != 0)
+        {
+            std::remove(tmpPath.c_str());
+            return false;
+        }
+
+        // Make the rename itself durable
+        std::size_t slash = path.find_last_of('/');
+        std::string dir = slash == std::string::npos ? "." : path.substr(0, slash + 1);
+        int dirFd = ::open(dir.c_str(), O_RDONLY);
+        if (dirFd >= 0)
+        {
+            fsync(dirFd);
+            ::close(dirFd);
+        }
+        return true;
+    }
+
+    // Restore a snapshot written by saveSnapshot into an empty manager. The
+    // file is mapped read-only and its records are used in place: no text
+    // parsing, no name lookups for edges, and one heapify per queue.
+    bool loadSnapshot(const std::string &path)
+    {
+        OpTimer timer(opStats, StatOp::SNAPSHOT);
+        if (!liveTasks.empty())
+            return false;
+
+        MappedFile file;
+        if (!file.open(path) || file.size() < sizeof(SnapshotHeader))
+            return false;
+
+        // Version 1 headers end before journalSequence
+        SnapshotHeader header = {};
+        std::memcpy(&header, file.data(), sizeof(header) - sizeof(header.journalSequence));
+        const std::size_t expectedHeaderSize = header.version == 1 ? sizeof(header) - sizeof(header.journalSequence) : sizeof(header);
+        if (header.version > 1)
+            std::memcpy(&header, file.data(), sizeof(header));
+        // Every field is untrusted, so bounds are checked by subtraction and
+        // division; a sum or product of two fields could wrap around
+        auto fits = [](std::uint64_t offset, std::uint64_t count, std::uint64_t elementSize, std::uint64_t limit)
+        {
+            return offset <= limit && count <= (limit - offset) / elementSize;
+        };
+        if (std::memcmp(header.magic, kSnapshotMagic, sizeof(header.magic)) != 0 || header.version < 1 || header.version > kSnapshotVersion ||
+            header.headerSize != expectedHeaderSize || header.fileSize != file.size() || header.tasksOffset < header.headerSize ||
+            !fits(header.tasksOffset, header.taskCount, sizeof(SnapshotTask), header.offsetsOffset) ||
+            !fits(header.offsetsOffset, header.taskCount + 1, sizeof(std::uint64_t), header.edgesOffset) ||
+            !fits(header.edgesOffset, header.edgeCount, sizeof(std::uint32_t), header.stringsOffset) ||
+            header.stringsOffset > header.fileSize || header.stringBytes != header.fileSize - header.stringsOffset ||
+            header.tasksOffset % alignof(SnapshotTask) != 0 || header.offsetsOffset % alignof(std::uint64_t) != 0 ||
+            header.edgesOffset % alignof(std::uint32_t) != 0)
+            return false;
+        if (fnv1a(file.data() + header.headerSize, file.size() - header.headerSize) != header.checksum)
+            return false;
+
+        const SnapshotTask *records = reinterpret_cast<const SnapshotTask *>(file.data() + header.tasksOffset);
+        const std::uint64_t *offsets = reinterpret_cast<const std::uint64_t *>(file.data() + header.offsetsOffset);
+        const std::uint32_t *edges = reinterpret_cast<const std::uint32_t *>(file.data() + header.edgesOffset);
+        const char *strings = file.data() + header.stringsOffset;
+
+        // Validate everything before touching the manager, including name
+        // uniqueness, so createTask cannot fail halfway through the load
+        if (offsets[0] != 0 || offsets[header.taskCount] != header.edgeCount)
+            return false;
+        std::unordered_set<std::string_view> names;
+        names.reserve(header.taskCount);
+        for (std::uint64_t i = 0; i < header.taskCount; ++i)
+        {
+            const SnapshotTask &record = records[i];
+            if (record.nameLength == 0 || record.nameLength > header.stringBytes || record.nameOffset > header.stringBytes - record.nameLength ||
+                (header.version >= 3 && record.duration < 0) ||
+                record.descriptionLength > header.stringBytes || record.descriptionOffset > header.stringBytes - record.descriptionLength ||
+                record.status > static_cast<std::uint8_t>(CompletionStatus::FINISHED) || offsets[i] > offsets[i + 1])
+                return false;
+            if (!names.insert(std::string_view(strings + record.nameOffset, record.nameLength)).second)
+                return false;
+            for (std::uint64_t e = offsets[i]; e < offsets[i + 1]; ++e)
+            {
+                if (edges[e] >= i) // Must point at an earlier task, which also rules out cycles
+                    return false;
+            }
+        }
+
+        scheduleValid = false;
+
+        // Out-degrees let every adjacency vector be sized exactly once
+        std::vector<std::uint32_t> dependentCount(header.taskCount, 0);
+        for (std::uint64_t e = 0; e < header.edgeCount; ++e)
+            ++dependentCount[edges[e]];
+
+        currentTime = static_cast<int>(header.currentTime);
+        deadlineWheel.reset(currentTime);
+        appliedSequence = header.journalSequence;
+        std::vector<GraphNode *> byIndex(header.taskCount);
+        reserveTasks(header.taskCount);
+        for (std::uint64_t i = 0; i < header.taskCount; ++i)
+        {
+            const SnapshotTask &record = records[i];
+            TaskId id = createTask(std::string(strings + record.nameOffset, record.nameLength),
+                                   std::string(strings + record.descriptionOffset, record.descriptionLength),
+                                   record.deadline, record.completion, header.version >= 3 ? record.duration : kDefaultDuration);
+            if (id == kInvalidTaskId)
+                return false;
+            Task *task = taskArena.at(id);
+            task->status = static_cast<CompletionStatus>(record.status);
+            taskQueue.pushUnordered(task);
+
+            GraphNode *node = nodeArena.at(id);
+            byIndex[i] = node;
+            node->dependencies.reserve(offsets[i + 1] - offsets[i]);
+            node->dependents.reserve(dependentCount[i]);
+            if (record.completed)
+            {
+                node->completed = true;
+                ++completedCount;
+                cancelDeadlineTimers(id);
+                task->approaching = task->overdue = false;
+            }
+            for (std::uint64_t e = offsets[i]; e < offsets[i + 1]; ++e)
+            {
+                GraphNode *dep = byIndex[edges[e]];
+                node->dependencies.push_back(dep);
+                dep->dependents.push_back(node);
+                if (!node->completed && !dep->completed)
+                    ++node->pendingDependencies;
+            }
+            if (!node->completed && node->pendingDependencies == 0)
+                readyQueue.pushUnordered(node);
+        }
+
+        taskQueue.rebuild();
+        readyQueue.rebuild();
+        return true;
+    }
+
+    // Replay the journal at PATH on top of the current state (normally a
+    // freshly loaded snapshot). Records already folded into the snapshot
+    // are skipped. Must run before a journal is attached. Returns the
+    // number of records applied, or -1 if the file cannot be read.
+    long replayJournal(const std::string &path)
+    {
+        scheduleValid = false;
+        bool clockMoved = false;
+        long applied = 0;
+        long read = Journal::replay(path, [&](const JournalRecord &record)
+                                    {
+            if (record.sequence <= appliedSequence)
+                return;
+            appliedSequence = record.sequence;
+            ++applied;
+            switch (record.op)
+            {
+            case JournalOp::ADD_TASK:
+            {
+                TaskId id = createTask(std::string(record.name), std::string(record.other), record.value, record.completion);
+                if (id != kInvalidTaskId)
+                {
+                    taskQueue.push(taskArena.at(id));
+                    readyQueue.push(nodeArena.at(id));
+                }
+                break;
+            }
+            case JournalOp::DELETE_TASK:
+            {
+                TaskId id = taskIndex.find(record.name);
+                if (id != kInvalidTaskId)
+                    removeTask(id);
+                break;
+            }
+            case JournalOp::ADD_DEPENDENCY:
+            {
+                GraphNode *node = findNode(record.name);
+                GraphNode *dep = findNode(record.other);
+                if (node && dep)
+                    insertEdge(node, dep);
+                break;
+            }
+            case JournalOp::SET_STATUS:
+            {
+                Task *task = findTask(record.name);
+                if (task && record.value >= 0 && record.value <= static_cast<std::int32_t>(CompletionStatus::FINISHED))
+                    markTaskCompleted(task, static_cast<CompletionStatus>(record.value));
+                break;
+            }
+            case JournalOp::ADVANCE_CLOCK:
+                // Re-scored once at the end instead of after every record
+                currentTime += record.value;
+                clockMoved = true;
+                fireDeadlineEvents();
+                break;
+            case JournalOp::SET_DURATION:
+            {
+                Task *task = findTask(record.name);
+                if (task && record.value >= 0)
+                {
+                    task->duration = record.value;
+                    rescoreTask(task);
+                }
+                break;
+            }
+            } });
+        if (clockMoved)
+            rescoreAllTasks();
+        return read < 0 ? -1 : applied;
+    }
+
+    // Log every later mutation to journal (nullptr detaches). The journal
+    // must continue numbering after lastAppliedSequence().
+    void attachJournal(Journal *log)
+    {
+        journal = log;
+    }
+
+    std::uint64_t lastAppliedSequence() const
+    {
+        return appliedSequence;
+    }
+
+    // Fold the journal into a fresh snapshot, then empty the journal. A
+    // crash in between is harmless: the snapshot records the last journal
+    // sequence it contains and replay skips those records.
+    bool checkpoint()
+    {
+        if (snapshotPath.empty() || !saveSnapshot(snapshotPath))
+            return false;
+        if (journal)
+        {
+            appliedSequence = journal->lastSequence();
+            return journal->truncate();
+        }
+        return true;
+    }
+
+    // Keep replay time bounded by folding a large journal into the snapshot
+    void compactJournal()
+    {
+        if (journal && !snapshotPath.empty() && journal->size() > compactionBytes)
+            checkpoint();
+    }
+
+    // Snapshot file used by the interactive menu; empty disables saving
+    void setSnapshotPath(const std::string &path)
+    {
+        snapshotPath = path;
+    }
+
+    // Number of worker threads executeTasks uses; 1 keeps the serial scheduler
+    void setParallelWorkers(unsigned workers)
+    {
+        parallelWorkers = std::max(1u, workers);
+    }
+
+#ifdef TM_HAS_COROUTINES
+    // Coroutine pool size executeTasks uses; 0 goes back to the thread schedulers
+    void setAsyncWorkers(unsigned workers)
+    {
+        asyncWorkers = workers;
+    }
+#endif
+
+    double getUserCompletionStatus()
+    {
+        std::cout << "Select completion status:" << std::endl;
+        std::cout << "1. Not Started" << std::endl;
+        std::cout << "2. Just Started" << std::endl;
+        std::cout << "3. Half Completed" << std::endl;
+        std::cout << "4. Almost Completed" << std::endl;
+        std::cout << "5. Finished" << std::endl;
+
+        int choice;
+        std::cout << "Enter your choice (1-5): ";
+        std::cin >> choice;
+
+        switch (choice)
+        {
+        case 1:
+            return 0.0;
+        case 2:
+            return 0.25;
+        case 3:
+            return 0.5;
+        case 4:
+            return 0.75;
+        case 5:
+            return 1.0;
+        default:
+            std::cout << "Invalid choice. Defaulting to Not Started." << std::endl;
+            return -1.0;
+        }
+    }
+
+    // Method to add a new task interactively during program execution
+    void addNewTask()
+    {
+        std::string name, description;
+        int deadline;
+
+        std::cin.ignore(); // Ignore the newline character from previous input
+
+        std::cout << "Enter task name: ";
+        std::getline(std::cin, name);
+
+        if (name.empty())
+        {
+            std::cout << "Error: Please enter a name for the task." << std::endl;
+            return; // Or handle the empty name case differently
+        }
+
+        std::cout << "Enter task description: ";
+        std::getline(std::cin, description);
+
+        deadline = readDeadline();
+        std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n'); // Clear the input buffer
+
+        if (!addTask(name, description, deadline, getUserCompletionStatus()).valid())
+            return;
+
+        displayTasks(); // Display all tasks after adding the new task
+    }
+
+    // Read a deadline. On a real clock it is entered as units from now.
+    int readDeadline()
+    {
+        int deadline = 0;
+        if (realClock())
+        {
+            syncClock();
+            std::cout << "Enter time units until the deadline: ";
+            std::cin >> deadline;
+            return currentTime + deadline;
+        }
+        std::cout << "Enter task deadline: ";
+        std::cin >> deadline;
+        return deadline;
+    }
+
+    // Execute tasks in dependency order, then offer the interactive menu
+    void executeTasks()
+    {
+        while (true)
+        {
+            syncClock();
+#ifdef TM_HAS_COROUTINES
+            if (asyncWorkers > 0)
+            {
+                AsyncRunStats stats = executeTasksAsync(asyncWorkers);
+                std::cout << "Async run: " << stats.executed << " task(s) on " << stats.workers << " worker(s), makespan "
+                          << stats.makespanMs << " ms, " << stats.failed << " failed" << std::endl;
+            }
+            else
+#endif
+            if (parallelWorkers > 1)
+            {
+                ParallelRunStats stats = executeTasksParallel(parallelWorkers);
+                std::cout << "Parallel run: " << stats.executed << " task(s) on " << stats.workers << " worker(s), makespan "
+                          << stats.makespanMs << " ms, utilization " << stats.utilization * 100.0 << "%, steals " << stats.steals << std::endl;
+            }
+            else
+            {
+                runReadyTasks();
+            }
+
+            compactJournal();
+
+            displayTasks();
+
+            std::cout << "Select an option:" << std::endl;
+            std::cout << "1. Add Task" << std::endl;
+            std::cout << "2. Delete Task" << std::endl;
+            std::cout << "3. View Tasks" << std::endl;
+            std::cout << "4. Exit" << std::endl;
+            std::cout << "5. Advance Clock" << std::endl;
+            std::cout << "6. Save Snapshot" << std::endl;
+            std::cout << "7. Critical Path" << std::endl;
+            std::cout << "8. Statistics" << std::endl;
+
+            int option;
+            std::cout << "Enter your choice (1-8): ";
+            if (!(std::cin >> option))
+                return; // Input closed
+
+            std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n'); // Clear the input buffer
+            syncClock(); // The prompt may have waited a long time
+
+            switch (option)
+            {
+            case 1:
+                addNewTask();
+                break;
+            case 2:
+                deleteTaskPrompt();
+                break;
+            case 3:
+                displayTasksPrompt();
+                break;
+            case 4:
+                if (!snapshotPath.empty())
+                    saveSnapshotPrompt();
+                std::cout << "Exiting the program." << std::endl;
+                return;
+            case 5:
+            {
+                int ticks;
+                std::cout << "Enter time units to advance: ";
+                std::cin >> ticks;
+                std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n'); // Clear the input buffer
+                advanceClock(ticks);
+                std::cout << "Clock is now at " << currentTime << "." << std::endl;
+                break;
+            }
+            case 6:
+                saveSnapshotPrompt();
+                break;
+            case 7:
+                displayCriticalPath();
+                break;
+            case 8:
+                displayStats();
+                break;
+            default:
+                std::cout << "Invalid option. Please try again." << std::endl;
+                break;
+            }
+        }
+    }
+
+    // Tasks at positions [offset, offset + count) when ordered by priority,
+    // highest first (ties by id so pages are stable). Only the first
+    // offset + count ids are kept and sorted: O(n log(offset + count)).
+    std::vector<Task *> topTasks(std::size_t count, std::size_t offset = 0) const
+    {
+        std::vector<Task *> page;
+        if (offset >= liveTasks.size() || count == 0)
+            return page;
+        std::size_t wanted = std::min(liveTasks.size(), offset + count);
+        std::vector<TaskId> best(wanted);
+        std::partial_sort_copy(liveTasks.begin(), liveTasks.end(), best.begin(), best.end(), [this](TaskId a, TaskId b)
+                               {
+            float pa = taskArena.at(a)->getPriority();
+            float pb = taskArena.at(b)->getPriority();
+            return pa > pb || (pa == pb && a < b); });
+
+        page.reserve(wanted - offset);
+        for (std::size_t i = offset; i < wanted; ++i)
+            page.push_back(taskArena.at(best[i]));
+        return page;
+    }
+
+    // Method to display one page of task details sorted by priority
+    void displayTasks(std::size_t offset = 0, std::size_t count = kTaskPageSize)
+    {
+        std::vector<Task *> page = topTasks(count, offset);
+
+        OutputBuffer out;
+        out.reserve(page.size() * 128 + 64);
+        if (page.empty())
+        {
+            out << "No tasks to show (" << liveTasks.size() << " in total).\n";
+            out.flush();
+            return;
+        }
+        out << "Tasks " << offset + 1 << "-" << offset + page.size() << " of " << liveTasks.size() << " (Sorted by Priority):\n";
+        for (Task *task : page)
+        {
+            out << "Name: " << task->getName() << ", Description: " << task->getDescription() << ", Deadline: " << task->getDeadline();
+            if (task->isOverdue())
+                out << " (overdue)";
+            else if (task->isApproachingDeadline())
+                out << " (due soon)";
+            out << ", Status: ";
+            float completionStatus = task->getStatus();
+            if (completionStatus == 0.0)
+                out << "Not started";
+            else if (completionStatus == 0.25)
+                out << "Just started";
+            else if (completionStatus == 0.5)
+                out << "Half completed";
+            else if (completionStatus == 0.75)
+                out << "Almost completed";
+            else if (completionStatus == 1.0)
+                out << "Finished";
+            else
+                out << "Unknown";
+
+            out << ", Priority: " << static_cast<double>(task->getPriority()) << '\n';
+        }
+        out.flush();
+    }
+
+    // Ask for a page number and show that page of the task view
+    void displayTasksPrompt()
+    {
+        std::size_t pages = std::max<std::size_t>(1, (liveTasks.size() + kTaskPageSize - 1) / kTaskPageSize);
+        std::size_t page = 1;
+        if (pages > 1)
+        {
+            std::cout << "Enter page (1-" << pages << "): ";
+            if (!(std::cin >> page) || page < 1 || page > pages)
+            {
+                std::cin.clear();
+                page = 1;
+            }
+            std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n'); // Clear the input buffer
+        }
+        displayTasks((page - 1) * kTaskPageSize, kTaskPageSize);
+    }
+
+    // Save to the configured snapshot path, asking for one if none is set
+    void saveSnapshotPrompt()
+    {
+        if (snapshotPath.empty())
+        {
+            std::cout << "Enter the snapshot file path: ";
+            std::getline(std::cin, snapshotPath);
+        }
+        if (checkpoint())
+            std::cout << "Snapshot saved to '" << snapshotPath << "'." << std::endl;
+        else
+            std::cout << "Error: could not write snapshot '" << snapshotPath << "'." << std::endl;
+    }
+
+    // Method to prompt user for dependency and add it
+    void addDependencyPrompt()
+    {
+        std::string taskName;
+        std::string dependencyName;
+        std::cout << "Enter the name of the task: ";
+        std::cin >> taskName;
+        std::cout << "Enter the name of the dependency task: ";
+        std::cin >> dependencyName;
+        if (addDependency(taskName, dependencyName))
+            std::cout << "Dependency added successfully!" << std::endl;
+    }
+};
+
+// Prebuilt instantiations, one per policy in dispatchPolicy
+using TaskManager = BasicTaskManager<LegacyPolicy>;
+using EdfTaskManager = BasicTaskManager<EdfPolicy>;
+using WsjfTaskManager = BasicTaskManager<WsjfPolicy>;
+
+// Lock-free multi-producer single-consumer queue (Vyukov). Producers link
+// a node with one atomic exchange; only the consumer thread may pop.
+template <typename T>
+class MpscQueue
+{
+private:
+    struct Node
+    {
+        std::atomic<Node *> next{nullptr};
+        T value;
+    };
+
+    alignas(64) std::atomic<Node *> head; // Last node pushed
+    alignas(64) Node *tail;               // Consumed node; tail->next is the front
+
+public:
+    MpscQueue()
+    {
+        tail = new Node();
+        head.store(tail, std::memory_order_relaxed);
+    }
+
+    MpscQueue(const MpscQueue &) = delete;
+    MpscQueue &operator=(const MpscQueue &) = delete;
+
+    ~MpscQueue()
+    {
+        T discard;
+        while (pop(discard))
+        {
+        }
+        delete tail;
+    }
+
+    void push(T value)
+    {
+        Node *node = new Node();
+        node->value = std::move(value);
+        Node *prev = head.exchange(node, std::memory_order_acq_rel);
+        prev->next.store(node, std::memory_order_release);
+    }
+
+    // Consumer only. May miss a push that has not finished linking yet.
+    bool pop(T &value)
+    {
+        Node *next = tail->next.load(std::memory_order_acquire);
+        if (!next)
+            return false;
+        value = std::move(next->value);
+        delete tail;
+        tail = next;
+        return true;
+    }
+
+    // Consumer only
+    bool empty() const
+    {
+        return tail->next.load(std::memory_order_acquire) == nullptr;
+    }
+};
+
+// A mutation or read submitted to a ConcurrentTaskManager
+template <typename Policy>
+struct TaskOperation
+{
+    enum class Kind
+    {
+        ADD_TASK,
+        DELETE_TASK,
+        ADD_DEPENDENCY,
+        CALL
+    };
+
+    Kind kind = Kind::CALL;
+    std::string name;  // Task name
+    std::string other; // Description, or dependency name
+    int deadline = 0;
+    double completion = 0.0;
+    int duration = kDefaultDuration;
+    std::function<void(BasicTaskManager<Policy> &)> call; // Runs on the owner thread
+};
+
+// Concurrent front end for a TaskManager. Any number of producer threads
+// submit operations through a lock-free queue; one owner thread drains it
+// and applies each run of adds or dependencies as a single bulk operation.
+// The TaskManager is only ever touched by the owner thread, so reads are
+// submitted too and answered through a future once every operation queued
+// before them has been applied.
+template <typename Policy>
+class BasicConcurrentTaskManager
+{
+private:
+    using Manager = BasicTaskManager<Policy>;
+    using Operation = TaskOperation<Policy>;
+    static constexpr std::size_t kMaxBatch = 4096;
+
+    Manager &manager;
+    MpscQueue<Operation> queue;
+    std::atomic<bool> sleeping{false};
+    std::atomic<bool> stopping{false};
+    std::mutex sleepLock; // Only taken to park or wake the owner
+    std::condition_variable wake;
+    std::atomic<std::uint64_t> appliedOperations{0};
+    std::atomic<std::uint64_t> appliedBatches{0};
+    std::thread owner;
+
+    void submit(Operation &&operation)
+    {
+        queue.push(std::move(operation));
+        // Pairs with the fence in ownerLoop: without it the flag load can be
+        // satisfied before the push leaves this core's store buffer
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (sleeping.load())
+        {
+            std::lock_guard<std::mutex> guard(sleepLock);
+            wake.notify_one();
+        }
+    }
+
+    // Apply a drained batch in submission order, grouping consecutive adds
+    // and consecutive dependencies into one bulk call each
+    void applyBatch(std::vector<Operation> &batch)
+    {
+        std::vector<TaskRecord> records;
+        std::vector<std::pair<std::string, std::string>> edges;
+        std::size_t i = 0;
+        while (i < batch.size())
+        {
+            Operation &operation = batch[i];
+            switch (operation.kind)
+            {
+            case Operation::Kind::ADD_TASK:
+                records.clear();
+                for (; i < batch.size() && batch[i].kind == Operation::Kind::ADD_TASK; ++i)
+                    records.push_back(TaskRecord{std::move(batch[i].name), std::move(batch[i].other), batch[i].deadline, batch[i].completion, batch[i].duration});
+                manager.addTasksBulk(records);
+                continue;
+            case Operation::Kind::ADD_DEPENDENCY:
+                edges.clear();
+                for (; i < batch.size() && batch[i].kind == Operation::Kind::ADD_DEPENDENCY; ++i)
+                    edges.emplace_back(std::move(batch[i].name), std::move(batch[i].other));
+                manager.addDependenciesBulk(edges);
+                continue;
+            case Operation::Kind::DELETE_TASK:
+            {
+                TaskId id = manager.taskIndex.find(operation.name);
+                if (id != kInvalidTaskId)
+                {
+                    if (manager.journal)
+                        manager.journal->logDeleteTask(operation.name);
+                    manager.removeTask(id);
+                }
+                break;
+            }
+            case Operation::Kind::CALL:
+                operation.call(manager);
+                break;
+            }
+            ++i;
+        }
+        appliedOperations.fetch_add(batch.size(), std::memory_order_relaxed);
+        appliedBatches.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void ownerLoop()
+    {
+        std::vector<Operation> batch;
+        batch.reserve(kMaxBatch);
+        Operation operation;
+        while (true)
+        {
+            batch.clear();
+            while (batch.size() < kMaxBatch && queue.pop(operation))
+                batch.push_back(std::move(operation));
+            if (!batch.empty())
+            {
+                applyBatch(batch);
+                if (manager.versioning)
+                    manager.publishVersion();
+                continue;
+            }
+            if (stopping.load())
+                return;
+
+            // Park until a producer sees the flag and wakes us. Each side
+            // stores, fences, then loads the other's variable, so either the
+            // re-check below sees the push or the producer sees the flag.
+            sleeping.store(true);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            {
+                std::unique_lock<std::mutex> guard(sleepLock);
+                wake.wait(guard, [&]
+                          { return !queue.empty() || stopping.load(); });
+            }
+            sleeping.store(false);
+        }
+    }
+
+public:
+    explicit BasicConcurrentTaskManager(Manager &target) : manager(target)
+    {
+        owner = std::thread(&BasicConcurrentTaskManager::ownerLoop, this);
+    }
+
+    BasicConcurrentTaskManager(const BasicConcurrentTaskManager &) = delete;
+    BasicConcurrentTaskManager &operator=(const BasicConcurrentTaskManager &) = delete;
+
+    // Apply everything still queued, then stop the owner thread
+    ~BasicConcurrentTaskManager()
+    {
+        {
+            std::lock_guard<std::mutex> guard(sleepLock);
+            stopping.store(true);
+        }
+        wake.notify_one();
+        owner.join();
+    }
+
+    void addTask(std::string name, std::string description, int deadline, double completion, int duration = kDefaultDuration)
+    {
+        Operation operation;
+        operation.kind = Operation::Kind::ADD_TASK;
+        operation.name = std::move(name);
+        operation.other = std::move(description);
+        operation.deadline = deadline;
+        operation.completion = completion;
+        operation.duration = duration;
+        submit(std::move(operation));
+    }
+
+    void deleteTask(std::string name)
+    {
+        Operation operation;
+        operation.kind = Operation::Kind::DELETE_TASK;
+        operation.name = std::move(name);
+        submit(std::move(operation));
+    }
+
+    void addDependency(std::string taskName, std::string dependencyName)
+    {
+        Operation operation;
+        operation.kind = Operation::Kind::ADD_DEPENDENCY;
+        operation.name = std::move(taskName);
+        operation.other = std::move(dependencyName);
+        submit(std::move(operation));
+    }
+
+    // Run fn(Manager &) on the owner thread after every operation this
+    // thread submitted earlier; the future carries its result
+    template <typename Fn>
+    auto call(Fn fn) -> std::future<decltype(fn(std::declval<Manager &>()))>
+    {
+        using Result = decltype(fn(std::declval<Manager &>()));
+        auto promise = std::make_shared<std::promise<Result>>();
+        std::future<Result> result = promise->get_future();
+        Operation operation;
+        operation.call = [promise, fn = std::move(fn)](Manager &target) mutable
+        {
+            if constexpr (std::is_void_v<Result>)
+            {
+                fn(target);
+                promise->set_value();
+            }
+            else
+                promise->set_value(fn(target));
+        };
+        submit(std::move(operation));
+        return result;
+    }
+
+    // Completes once everything submitted before it has been applied and,
+    // if snapshots are in use, published
+    std::future<void> flush()
+    {
+        return call([](Manager &target)
+                    {
+                        if (target.versioning)
+                            target.publishVersion();
+                    });
+    }
+
+    std::future<std::size_t> taskCount()
+    {
+        return call([](Manager &target)
+                    { return target.taskCount(); });
+    }
+
+    // State as of the last batch the owner thread applied, readable on the
+    // calling thread without waiting for the owner. The first call waits
+    // until everything submitted before it is applied; from then on the
+    // owner publishes a version after every batch.
+    std::shared_ptr<const TaskVersion> snapshot()
+    {
+        std::shared_ptr<const TaskVersion> version = manager.currentVersion();
+        if (!version)
+        {
+            call([](Manager &target)
+                 { target.publishVersion(); })
+                .wait();
+            version = manager.currentVersion();
+        }
+        return version;
+    }
+
+    std::uint64_t operationsApplied() const
+    {
+        return appliedOperations.load(std::memory_order_relaxed);
+    }
+
+    std::uint64_t batchesApplied() const
+    {
+        return appliedBatches.load(std::memory_order_relaxed);
+    }
+};
+
+using ConcurrentTaskManager = BasicConcurrentTaskManager<LegacyPolicy>;
+
+// Summary of a bulk load
+struct IngestStats
+{
+    std::size_t tasks = 0;
+    std::size_t edges = 0;
+    std::size_t skippedTasks = 0; // Duplicate names
+    std::size_t skippedEdges = 0; // Unknown tasks or cycle-closing edges
+    std::size_t badLines = 0;
+    std::size_t bytes = 0;
+    double seconds = 0.0;
+};
+
+// Splits a line on tabs into at most maxFields views
+inline std::size_t splitFields(std::string_view line, std::string_view *fields, std::size_t maxFields)
+{
+    std::size_t count = 0;
+    while (count + 1 < maxFields)
+    {
+        std::size_t tab = line.find('\t');
+        if (tab == std::string_view::npos)
+            break;
+        fields[count++] = line.substr(0, tab);
+        line.remove_prefix(tab + 1);
+    }
+    fields[count++] = line;
+    return count;
+}
+
+// Stream a task file into the manager. Lines are tab separated:
+//   T <name> <description> <deadline> <completion 0..1> [<duration>]
+//   D <task> <dependency>
+// Blank lines and lines starting with '#' are ignored. The input is read
+// in 1 MiB blocks, then all tasks are added with addTasksBulk and all
+// edges with addDependenciesBulk.
+template <typename Policy>
+IngestStats loadTaskStream(BasicTaskManager<Policy> &manager, std::FILE *in)
+{
+    IngestStats stats;
+    auto start = std::chrono::steady_clock::now();
+
+    std::vector<TaskRecord> records;
+    std::vector<std::pair<std::string, std::string>> edges;
+
+    auto parseLine = [&](std::string_view line)
+    {
+        if (!line.empty() && line.back() == '\r')
+            line.remove_suffix(1);
+        if (line.empty() || line.front() == '#')
+            return;
+
+        std::string_view fields[6];
+        std::size_t count = splitFields(line, fields, 6);
+        if (fields[0] == "T" && (count == 5 || count == 6))
+        {
+            TaskRecord record;
+            record.name.assign(fields[1]);
+            record.description.assign(fields[2]);
+            auto deadlineEnd = fields[3].data() + fields[3].size();
+            auto completionEnd = fields[4].data() + fields[4].size();
+            if (std::from_chars(fields[3].data(), deadlineEnd, record.deadline).ptr != deadlineEnd ||
+                std::from_chars(fields[4].data(), completionEnd, record.completion).ptr != completionEnd ||
+                record.name.empty())
+            {
+                ++stats.badLines;
+                return;
+            }
+            if (count == 6)
+            {
+                auto durationEnd = fields[5].data() + fields[5].size();
+                if (std::from_chars(fields[5].data(), durationEnd, record.duration).ptr != durationEnd || record.duration < 0)
+                {
+                    ++stats.badLines;
+                    return;
+                }
+            }
+            records.push_back(std::move(record));
+        }
+        else if (fields[0] == "D" && count == 3)
+        {
+            edges.emplace_back(std::string(fields[1]), std::string(fields[2]));
+        }
+        else
+        {
+            ++stats.badLines;
+        }
+    };
+
+    std::vector<char> buffer(1 << 20);
+    std::size_t filled = 0;
+    while (true)
+    {
+        std::size_t read = std::fread(buffer.data() + filled, 1, buffer.size() - filled, in);
+        stats.bytes += read;
+        filled += read;
+
+        std::string_view pending(buffer.data(), filled);
+        std::size_t newline;
+        while ((newline = pending.find('\n')) != std::string_view::npos)
+        {
+            parseLine(pending.substr(0, newline));
+            pending.remove_prefix(newline + 1);
+        }
+
+        if (read == 0)
+        {
+            parseLine(pending); // Last line without a trailing newline
+            break;
+        }
+
+        // Keep the partial line; grow the buffer if one line fills it
+        std::memmove(buffer.data(), pending.data(), pending.size());
+        filled = pending.size();
+        if (filled == buffer.size())
+            buffer.resize(buffer.size() * 2);
+    }
+
+    std::size_t requestedTasks = records.size();
+    stats.tasks = manager.addTasksBulk(records);
+    stats.skippedTasks = requestedTasks - stats.tasks;
+    stats.edges = manager.addDependenciesBulk(edges);
+    stats.skippedEdges = edges.size() - stats.edges;
+
+    stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return stats;
+}
+
+// Set by SIGINT or SIGTERM to stop TaskServer::run
+inline std::atomic<bool> &serverStopRequested()
+{
+    static std::atomic<bool> requested(false);
+    return requested;
+}
+
+// Daemon front end. One epoll loop owns the TaskManager and serves any
+// number of clients on a Unix-domain or loopback TCP socket, so nothing
+// is locked. Requests are lines of tab-separated fields, like task files:
+//   ADD name description deadline completion [duration]  OK | ERR exists
+//   DEL name                                            OK | ERR not found
+//   DEP task dependency                                 OK | ERR not found | ERR cycle
+//   NEXT                                                OK name | ERR empty  (most urgent ready task)
+//   DONE name                                           OK | ERR not found   (mark finished)
+//   GET name                                            OK deadline completion priority duration state
+//   TOP count                                           OK name...
+//   CLOCK [ticks]                                       OK time
+//   PING                                                OK
+// Malformed requests get ERR syntax. Clients may pipeline: every complete
+// line of a read is answered in order and the replies go back in one
+// write, and each run of ADD lines becomes one addTasksBulk call. Reads
+// are capped per wakeup and a client that stops reading its replies is
+// not read from until it catches up, so no client can stall the others.
+template <typename Policy>
+class TaskServer
+{
+private:
+    static constexpr std::size_t kReadBudget = 1 << 20;   // Bytes read from one client per wakeup
+    static constexpr std::size_t kOutputLimit = 4u << 20; // Unsent reply bytes before reading pauses
+    static constexpr int kMaxEvents = 256;
+
+    struct Connection
+    {
+        std::string input;
+        std::string output;
+        std::size_t sent = 0; // Bytes of output already written
+        bool paused = false;  // Reading stopped until output drains
+        bool closed = false;  // Peer finished sending
+    };
+
+    BasicTaskManager<Policy> &manager;
+    int listenFd = -1;
+    int epollFd = -1;
+    std::string socketPath; // Unlinked on shutdown
+    std::unordered_map<int, Connection> connections;
+    std::vector<TaskRecord> addRun;                 // Current run of ADD requests
+    std::unordered_set<std::string_view> addNames;  // Names in addRun, viewing the input buffer
+    std::uint64_t requests = 0;
+
+    static std::vector<std::string_view> splitFields(std::string_view line)
+    {
+        std::vector<std::string_view> fields;
+        std::size_t start = 0;
+        while (true)
+        {
+            std::size_t tab = line.find('\t', start);
+            fields.push_back(line.substr(start, tab == std::string_view::npos ? std::string_view::npos : tab - start));
+            if (tab == std::string_view::npos)
+                return fields;
+            start = tab + 1;
+        }
+    }
+
+    template <typename T>
+    static bool parseNumber(std::string_view text, T &value)
+    {
+        if constexpr (std::is_floating_point_v<T>)
+        {
+            // std::from_chars for doubles is missing from older libstdc++
+            std::string copy(text);
+            char *end = nullptr;
+            value = std::strtod(copy.c_str(), &end);
+            return !copy.empty() && end == copy.c_str() + copy.size();
+        }
+        else
+        {
+            auto result = std::from_chars(text.data(), text.data() + text.size(), value);
+            return result.ec == std::errc() && result.ptr == text.data() + text.size();
+        }
+    }
+
+    static void appendNumber(std::string &out, long long value)
+    {
+        char digits[24];
+        auto result = std::to_chars(digits, digits + sizeof(digits), value);
+        out.append(digits, result.ptr);
+    }
+
+    static void appendNumber(std::string &out, double value)
+    {
+        char digits[32];
+        int length = std::snprintf(digits, sizeof(digits), "%g", value);
+        out.append(digits, static_cast<std::size_t>(length));
+    }
+
+    void flushAdds()
+    {
+        if (addRun.empty())
+            return;
+        manager.addTasksBulk(addRun);
+        addRun.clear();
+        addNames.clear();
+    }
+
+    // Execute one request line and append its reply
+    void execute(std::string_view line, std::string &out)
+    {
+        ++requests;
+        if (!line.empty() && line.back() == '\r')
+            line.remove_suffix(1);
+        std::vector<std::string_view> fields = splitFields(line);
+        std::string_view command = fields[0];
+
+        if (command == "ADD")
+        {
+            int deadline = 0;
+            double completion = 0.0;
+            int duration = kDefaultDuration;
+            if ((fields.size() != 5 && fields.size() != 6) || fields[1].empty() || !parseNumber(fields[3], deadline) ||
+                !parseNumber(fields[4], completion) || completion < 0.0 || completion > 1.0 ||
+                (fields.size() == 6 && (!parseNumber(fields[5], duration) || duration < 0)))
+            {
+                out += "ERR syntax\n";
+                return;
+            }
+            if (manager.findTask(fields[1]) || !addNames.insert(fields[1]).second)
+            {
+                out += "ERR exists\n";
+                return;
+            }
+            addRun.push_back(TaskRecord{std::string(fields[1]), std::string(fields[2]), deadline, completion, duration});
+            out += "OK\n";
+            return;
+        }
+
+        // Every other request sees the adds before it
+        flushAdds();
+        if (command == "DEL" && fields.size() == 2)
+        {
+            out += manager.deleteTask(std::string(fields[1])) ? "OK\n" : "ERR not found\n";
+        }
+        else if (command == "DEP" && fields.size() == 3)
+        {
+            if (!manager.findTask(fields[1]) || !manager.findTask(fields[2]))
+                out += "ERR not found\n";
+            else
+                out += manager.addDependency(std::string(fields[1]), std::string(fields[2])) ? "OK\n" : "ERR cycle\n";
+        }
+        else if (command == "NEXT" && fields.size() == 1)
+        {
+            Task *task = manager.nextReadyTask();
+            if (!task)
+                out += "ERR empty\n";
+            else
+            {
+                out += "OK\t";
+                out += task->getName();
+                out += '\n';
+            }
+        }
+        else if (command == "DONE" && fields.size() == 2)
+        {
+            Task *task = manager.findTask(fields[1]);
+            if (!task)
+                out += "ERR not found\n";
+            else
+            {
+                manager.markTaskCompleted(task, CompletionStatus::FINISHED);
+                out += "OK\n";
+            }
+        }
+        else if (command == "GET" && fields.size() == 2)
+        {
+            Task *task = manager.findTask(fields[1]);
+            if (!task)
+            {
+                out += "ERR not found\n";
+                return;
+            }
+            out += "OK\t";
+            appendNumber(out, static_cast<long long>(task->getDeadline()));
+            out += '\t';
+            appendNumber(out, static_cast<double>(task->getCompletionFactor()));
+            out += '\t';
+            appendNumber(out, static_cast<double>(task->getPriority()));
+            out += '\t';
+            appendNumber(out, static_cast<long long>(task->getDuration()));
+            out += task->isOverdue() ? "\toverdue\n" : task->isApproachingDeadline() ? "\tdue soon\n" : "\ton time\n";
+        }
+        else if (command == "TOP" && fields.size() == 2)
+        {
+            std::size_t count = 0;
+            if (!parseNumber(fields[1], count))
+            {
+                out += "ERR syntax\n";
+                return;
+            }
+            out += "OK";
+            for (Task *task : manager.topTasks(count))
+            {
+                out += '\t';
+                out += task->getName();
+            }
+            out += '\n';
+        }
+        else if (command == "CLOCK" && fields.size() <= 2)
+        {
+            int ticks = 0;
+            if (fields.size() == 2 && (!parseNumber(fields[1], ticks) || ticks < 0))
+            {
+                out += "ERR syntax\n";
+                return;
+            }
+            if (ticks > 0)
+                manager.advanceClock(ticks);
+            out += "OK\t";
+            appendNumber(out, static_cast<long long>(manager.getCurrentTime()));
+            out += '\n';
+        }
+        else if (command == "PING" && fields.size() == 1)
+        {
+            out += "OK\n";
+        }
+        else
+        {
+            out += "ERR syntax\n";
+        }
+    }
+
+    void watch(int fd, Connection &connection)
+    {
+        epoll_event event{};
+        if (!connection.paused && !connection.closed)
+            event.events |= EPOLLIN | EPOLLRDHUP;
+        if (connection.sent < connection.output.size())
+            event.events |= EPOLLOUT;
+        event.data.fd = fd;
+        epoll_ctl(epollFd, EPOLL_CTL_MOD, fd, &event);
+    }
+
+    void drop(int fd)
+    {
+        epoll_ctl(epollFd, EPOLL_CTL_DEL, fd, nullptr);
+        ::close(fd);
+        connections.erase(fd);
+    }
+
+    // Write as much pending output as the socket takes. Returns false if
+    // the connection is gone.
+    bool sendOutput(int fd, Connection &connection)
+    {
+        while (connection.sent < connection.output.size())
+        {
+            ssize_t n = ::send(fd, connection.output.data() + connection.sent, connection.output.size() - connection.sent, MSG_NOSIGNAL);
+            if (n < 0)
+            {
+                if (errno == EINTR)
+                    continue;
+                return errno == EAGAIN || errno == EWOULDBLOCK;
+            }
+            connection.sent += static_cast<std::size_t>(n);
+        }
+        connection.output.clear();
+        connection.sent = 0;
+        return true;
+    }
+
+    // Read what the client sent, execute every complete line and reply
+    void serve(int fd, Connection &connection)
+    {
+        std::size_t budget = kReadBudget;
+        char buffer[64 * 1024];
+        while (budget > 0)
+        {
+            ssize_t n = ::recv(fd, buffer, std::min(sizeof(buffer), budget), 0);
+            if (n > 0)
+            {
+                connection.input.append(buffer, static_cast<std::size_t>(n));
+                budget -= static_cast<std::size_t>(n);
+                continue;
+            }
+            if (n == 0)
+                connection.closed = true;
+            else if (errno == EINTR)
+                continue;
+            else if (errno != EAGAIN && errno != EWOULDBLOCK)
+                connection.closed = true;
+            break;
+        }
+
+        std::string_view input(connection.input);
+        std::size_t consumed = 0;
+        for (std::size_t newline; (newline = input.find('\n', consumed)) != std::string_view::npos; consumed = newline + 1)
+            execute(input.substr(consumed, newline - consumed), connection.output);
+        flushAdds(); // Before the buffer its names view is reused
+        connection.input.erase(0, consumed);
+    }
+
+    void accept()
+    {
+        while (true)
+        {
+            int fd = ::accept4(listenFd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+            if (fd < 0)
+                return;
+            int one = 1;
+            setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one)); // Fails harmlessly on Unix sockets
+            epoll_event event{};
+            event.events = EPOLLIN | EPOLLRDHUP;
+            event.data.fd = fd;
+            epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &event);
+            connections.emplace(fd, Connection());
+        }
+    }
+
+    bool startListening(int fd, const sockaddr *address, socklen_t length)
+    {
+        listenFd = fd;
+        epollFd = epoll_create1(EPOLL_CLOEXEC);
+        if (listenFd < 0 || epollFd < 0 || ::bind(listenFd, address, length) != 0 || ::listen(listenFd, SOMAXCONN) != 0)
+            return false;
+        epoll_event event{};
+        event.events = EPOLLIN;
+        event.data.fd = listenFd;
+        return epoll_ctl(epollFd, EPOLL_CTL_ADD, listenFd, &event) == 0;
+    }
+
+public:
+    explicit TaskServer(BasicTaskManager<Policy> &target) : manager(target) {}
+    TaskServer(const TaskServer &) = delete;
+    TaskServer &operator=(const TaskServer &) = delete;
+
+    ~TaskServer()
+    {
+        for (auto &entry : connections)
+            ::close(entry.first);
+        if (epollFd >= 0)
+            ::close(epollFd);
+        if (listenFd >= 0)
+            ::close(listenFd);
+        if (!socketPath.empty())
+            ::unlink(socketPath.c_str());
+    }
+
+    // Listen on a Unix-domain socket at path, replacing a stale one
+    bool listenUnix(const std::string &path)
+    {
+        sockaddr_un address{};
+        if (path.size() >= sizeof(address.sun_path))
+            return false;
+        address.sun_family = AF_UNIX;
+        std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+        ::unlink(path.c_str());
+        socketPath = path;
+        return startListening(::socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0), reinterpret_cast<sockaddr *>(&address), sizeof(address));
+    }
+
+    // Listen on 127.0.0.1:port
+    bool listenTcp(std::uint16_t port)
+    {
+        sockaddr_in address{};
+        address.sin_family = AF_INET;
+        address.sin_port = htons(port);
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        int fd = ::socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        int one = 1;
+        setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+        return startListening(fd, reinterpret_cast<sockaddr *>(&address), sizeof(address));
+    }
+
+    // Serve until serverStopRequested() is set. A real clock is synced on
+    // every wakeup, at least every 100 ms.
+    void run()
+    {
+        epoll_event events[kMaxEvents];
+        while (!serverStopRequested().load())
+        {
+            int ready = epoll_wait(epollFd, events, kMaxEvents, manager.realClock() ? 100 : 500);
+            if (ready < 0 && errno != EINTR)
+                return;
+            manager.syncClock();
+            for (int i = 0; i < ready; ++i)
+            {
+                int fd = events[i].data.fd;
+                if (fd == listenFd)
+                {
+                    accept();
+                    continue;
+                }
+                auto found = connections.find(fd);
+                if (found == connections.end())
+                    continue;
+                Connection &connection = found->second;
+                if (events[i].events & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR))
+                    serve(fd, connection);
+                if (!sendOutput(fd, connection) || (connection.closed && connection.output.empty()))
+                {
+                    drop(fd);
+                    continue;
+                }
+                connection.paused = connection.output.size() - connection.sent > kOutputLimit;
+                watch(fd, connection);
+            }
+            manager.compactJournal();
+        }
+    }
+
+    std::size_t clientCount() const
+    {
+        return connections.size();
+    }
+
+    std::uint64_t requestCount() const
+    {
+        return requests;
+    }
+};
+
+// Define TASK_MANAGER_NO_MAIN to include this file from another program
+// (the benchmarks do)
+#ifndef TASK_MANAGER_NO_MAIN
+// Upper bound for the worker counts given on the command line
+constexpr long kMaxFlagWorkers = 4096;
+
+// Read the value of a numeric command-line flag. Anything but a whole
+// number in [min, max] is reported against the flag and rejected.
+inline bool parseFlagNumber(const std::string &flag, std::string_view text, long min, long max, long &value)
+{
+    auto result = std::from_chars(text.data(), text.data() + text.size(), value);
+    if (text.empty() || result.ec != std::errc() || result.ptr != text.data() + text.size() || value < min || value > max)
+    {
+        std::cerr << "Error: " << flag << " expects a whole number from " << min << " to " << max << ", got '" << text << "'." << std::endl;
+        return false;
+    }
+    return true;
+}
+
+template <typename Policy>
+int runTaskManager(int argc, char *argv[])
+{
+    BasicTaskManager<Policy> taskManager;
+
+    // Optional: --parallel N runs ready tasks on N worker threads (0 = all cores)
+    //           --async N runs them as coroutines on N threads (C++20 builds only)
+    //           --load PATH bulk-loads a task file ('-' reads stdin) instead of prompting
+    //           --snapshot PATH restores PATH if it exists and saves it again on exit
+    //           --journal PATH replays PATH on startup and logs every change to it
+    //           --log-level LEVEL sets the message threshold (trace, debug, info, warn, error, off)
+    //           --real-clock MS ties one clock unit to MS milliseconds of wall time
+    //           --serve PATH serves the line protocol on a Unix socket instead of the menu
+    //           --serve-tcp PORT serves it on 127.0.0.1:PORT
+    //           --policy NAME is read by main
+    std::string loadPath;
+    std::string snapshotPath;
+    std::string journalPath;
+    long clockUnitMs = 0;
+    std::string servePath;
+    long servePort = 0;
+    bool logLevelSet = false;
+    for (int i = 1; i + 1 < argc; ++i)
+    {
+        std::string arg = argv[i];
+        if (arg == "--parallel")
+        {
+            long workers = 0;
+            if (!parseFlagNumber(arg, argv[++i], 0, kMaxFlagWorkers, workers))
+                return 1;
+            taskManager.setParallelWorkers(workers == 0 ? std::thread::hardware_concurrency() : static_cast<unsigned>(workers));
+        }
+#ifdef TM_HAS_COROUTINES
+        else if (arg == "--async")
+        {
+            long workers = 0;
+            if (!parseFlagNumber(arg, argv[++i], 0, kMaxFlagWorkers, workers))
+                return 1;
+            taskManager.setAsyncWorkers(workers == 0 ? std::thread::hardware_concurrency() : static_cast<unsigned>(workers));
+        }
+#endif
+        else if (arg == "--load")
+        {
+            loadPath = argv[++i];
+        }
+        else if (arg == "--snapshot")
+        {
+            snapshotPath = argv[++i];
+        }
+        else if (arg == "--journal")
+        {
+            journalPath = argv[++i];
+        }
+        else if (arg == "--real-clock")
+        {
+            // Up to one day of wall time per clock unit
+            if (!parseFlagNumber(arg, argv[++i], 1, 86400000, clockUnitMs))
+                return 1;
+        }
+        else if (arg == "--serve")
+        {
+            servePath = argv[++i];
+        }
+        else if (arg == "--serve-tcp")
+        {
+            if (!parseFlagNumber(arg, argv[++i], 1, 65535, servePort))
+                return 1;
+        }
+        else if (arg == "--log-level")
+        {
+            static const char *const levels[] = {"trace", "debug", "info", "warn", "error", "off"};
+            std::string level = argv[++i];
+            auto found = std::find(std::begin(levels), std::end(levels), level);
+            if (found == std::end(levels))
+            {
+                std::cerr << "Error: unknown log level '" << level << "'." << std::endl;
+                return 1;
+            }
+            logLevel().store(static_cast<int>(found - std::begin(levels)));
+            logLevelSet = true;
+        }
+    }
+
+    bool preloaded = false;
+    if (!snapshotPath.empty())
+    {
+        taskManager.setSnapshotPath(snapshotPath);
+        if (access(snapshotPath.c_str(), F_OK) == 0)
+        {
+            auto start = std::chrono::steady_clock::now();
+            if (!taskManager.loadSnapshot(snapshotPath))
+            {
+                std::cerr << "Error: '" << snapshotPath << "' is not a valid snapshot." << std::endl;
+                return 1;
+            }
+            std::cout << "Restored " << taskManager.taskCount() << " task(s) from '" << snapshotPath << "' in "
+                      << std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() << " s" << std::endl;
+            preloaded = true;
+        }
+    }
+
+    Journal journal;
+    if (!journalPath.empty())
+    {
+        long replayed = taskManager.replayJournal(journalPath);
+        if (replayed < 0 || !journal.open(journalPath, taskManager.lastAppliedSequence()))
+        {
+            std::cerr << "Error: cannot use journal '" << journalPath << "'." << std::endl;
+            return 1;
+        }
+        if (replayed > 0)
+        {
+            std::cout << "Replayed " << replayed << " journal record(s)." << std::endl;
+            preloaded = true;
+        }
+        taskManager.attachJournal(&journal);
+    }
+
+    if (!loadPath.empty())
+    {
+        std::FILE *in = loadPath == "-" ? stdin : std::fopen(loadPath.c_str(), "rb");
+        if (!in)
+        {
+            std::cerr << "Error: cannot open '" << loadPath << "'." << std::endl;
+            return 1;
+        }
+        IngestStats stats = loadTaskStream(taskManager, in);
+        if (in != stdin)
+            std::fclose(in);
+
+        std::cout << "Loaded " << stats.tasks << " task(s) and " << stats.edges << " dependencies from "
+                  << stats.bytes / 1048576.0 << " MiB in " << stats.seconds << " s ("
+                  << (stats.seconds > 0.0 ? stats.tasks / stats.seconds : 0.0) << " tasks/s)" << std::endl;
+        if (stats.skippedTasks || stats.skippedEdges || stats.badLines)
+            std::cout << "Skipped " << stats.skippedTasks << " duplicate task(s), " << stats.skippedEdges
+                      << " invalid or cyclic dependencies and " << stats.badLines << " malformed line(s)." << std::endl;
+        preloaded = true;
+    }
+
+    if (clockUnitMs > 0)
+        taskManager.setRealClock(std::chrono::milliseconds(clockUnitMs));
+
+    if (!servePath.empty() || servePort > 0)
+    {
+        if (!logLevelSet)
+            logLevel().store(static_cast<int>(LogLevel::ERROR)); // Clients get every failure as a reply
+        TaskServer<Policy> server(taskManager);
+        bool listening = servePort > 0 ? server.listenTcp(static_cast<std::uint16_t>(servePort)) : server.listenUnix(servePath);
+        if (!listening)
+        {
+            std::cerr << "Error: cannot listen on '" << (servePort > 0 ? std::to_string(servePort) : servePath) << "'." << std::endl;
+            return 1;
+        }
+        serverStopRequested().store(false); // Initialise before a handler can touch it
+        struct sigaction stop{};
+        stop.sa_handler = [](int)
+        { serverStopRequested().store(true); };
+        sigaction(SIGINT, &stop, nullptr);
+        sigaction(SIGTERM, &stop, nullptr);
+        std::cout << "Serving " << taskManager.taskCount() << " task(s); Ctrl-C stops." << std::endl;
+        server.run();
+        std::cout << "Served " << server.requestCount() << " request(s)." << std::endl;
+        if (!snapshotPath.empty() && !taskManager.checkpoint())
+            std::cerr << "Error: could not write snapshot '" << snapshotPath << "'." << std::endl;
+        return 0;
+    }
+
+    if (preloaded)
+    {
+        taskManager.executeTasks();
+        return 0;
+    }
+
+    // Prompt user to create tasks
+    int numTasks;
+    std::cout << "Enter the number of tasks: ";
+    std::cin >> numTasks;
+    std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n'); // Clear the input buffer
+
+    for (int i = 0; i < numTasks; ++i)
+    {
+        std::string name, description;
+        int deadline;
+
+        std::cout << "Enter task name: ";
+        std::getline(std::cin, name);
+
+        std::cout << "Enter task description: ";
+        std::getline(std::cin, description);
+
+        deadline = taskManager.readDeadline();
+
+        double completion = taskManager.getUserCompletionStatus();
+        cout << "Completion : " << completion << std::endl;
+        std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n'); // Clear the input buffer
+        taskManager.addTask(name, description, deadline, completion);
+    }
+
+    // Prompt user to add dependencies
+    char addDependencies;
+    std::cout << "Do you want to add dependencies between tasks? (Y/N): ";
+    std::cin >> addDependencies;
+
+    if (addDependencies == 'Y' || addDependencies == 'y')
+    {
+        taskManager.addDependencyPrompt();
+    }
+
+    // Execute tasks
+    taskManager.executeTasks();
+
+    return 0;
+}
+int main(int argc, char *argv[])
+{
+    // Optional: --policy NAME orders the queues by legacy (default), edf or wsjf
+    std::string policyName = LegacyPolicy::name;
+    for (int i = 1; i + 1 < argc; ++i)
+    {
+        if (std::string(argv[i]) == "--policy")
+            policyName = argv[++i];
+    }
+
+    int result = 1;
+    if (!dispatchPolicy(policyName, [&](auto policy)
+                        { result = runTaskManager<decltype(policy)>(argc, argv); }))
+    {
+        std::cerr << "Error: unknown policy '" << policyName << "'." << std::endl;
+        return 1;
+    }
+    return result;
+}
+#endif